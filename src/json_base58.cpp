@@ -0,0 +1,148 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_base58.h>
+#include <openssl/sha.h>
+#include <cstring>
+#include <vector>
+
+namespace Json
+{
+
+char const base58Alphabet[59] =
+    "rpshnaf39wBUDNEGHJKLM4PQRST7VWXYZ2bcdeCg65jkm8oFqi1tuvAxyz";
+
+namespace {
+
+void
+checksum ( std::uint8_t const* data, std::size_t size, std::uint8_t* out )
+{
+    std::uint8_t digest[SHA256_DIGEST_LENGTH];
+    SHA256 ( data, size, digest );
+    SHA256 ( digest, sizeof ( digest ), digest );
+    std::memcpy ( out, digest, 4 );
+}
+
+} // namespace
+
+void
+base58CheckEncode ( std::uint8_t type, std::uint8_t const* data,
+                    std::size_t size, std::string& out )
+{
+    // Type byte, data and checksum.
+    std::vector<std::uint8_t> payload ( size + 5 );
+    payload[0] = type;
+    std::memcpy ( payload.data () + 1, data, size );
+    checksum ( payload.data (), size + 1, payload.data () + size + 1 );
+
+    // Repeated division of the payload by 58, which yields the digits
+    // least significant first. Each byte needs at most 1.37 digits.
+    std::vector<char> encoded;
+    encoded.reserve ( payload.size () * 138 / 100 + 1 );
+    std::size_t zeros = 0;
+
+    while ( zeros < payload.size ()  &&  payload[zeros] == 0 )
+        ++zeros;
+
+    for ( std::size_t start = zeros; start < payload.size (); )
+    {
+        unsigned remainder = 0;
+
+        for ( std::size_t i = start; i < payload.size (); ++i )
+        {
+            unsigned const n = remainder * 256 + payload[i];
+            payload[i] = static_cast<std::uint8_t> ( n / 58 );
+            remainder = n % 58;
+        }
+
+        encoded.push_back ( base58Alphabet[remainder] );
+
+        while ( start < payload.size ()  &&  payload[start] == 0 )
+            ++start;
+    }
+
+    out.append ( zeros, base58Alphabet[0] );
+    out.append ( encoded.rbegin (), encoded.rend () );
+}
+
+bool
+base58CheckDecode ( std::uint8_t type, const char* begin,
+                    const char* end, std::string& out )
+{
+    static struct DecodeTable
+    {
+        signed char values[256];
+
+        DecodeTable ()
+        {
+            std::memset ( values, -1, sizeof ( values ) );
+
+            for ( int i = 0; i < 58; ++i )
+                values[static_cast<unsigned char> ( base58Alphabet[i] )] =
+                    static_cast<signed char> ( i );
+        }
+    } const table;
+
+    std::size_t zeros = 0;
+
+    while ( begin + zeros != end  &&  begin[zeros] == base58Alphabet[0] )
+        ++zeros;
+
+    // Multiply the bytes decoded so far by 58 and add each digit, most
+    // significant byte first.
+    std::vector<std::uint8_t> bytes;
+
+    for ( const char* p = begin + zeros; p != end; ++p )
+    {
+        int carry = table.values[static_cast<unsigned char> ( *p )];
+
+        if ( carry < 0 )
+            return false;
+
+        for ( auto it = bytes.rbegin (); it != bytes.rend (); ++it )
+        {
+            carry += 58 * *it;
+            *it = static_cast<std::uint8_t> ( carry );
+            carry >>= 8;
+        }
+
+        while ( carry != 0 )
+        {
+            bytes.insert ( bytes.begin (), static_cast<std::uint8_t> ( carry ) );
+            carry >>= 8;
+        }
+    }
+
+    bytes.insert ( bytes.begin (), zeros, 0 );
+
+    if ( bytes.size () < 5  ||  bytes[0] != type )
+        return false;
+
+    std::uint8_t expected[4];
+    checksum ( bytes.data (), bytes.size () - 4, expected );
+
+    if ( std::memcmp ( expected, bytes.data () + bytes.size () - 4, 4 ) != 0 )
+        return false;
+
+    out.append ( bytes.begin () + 1, bytes.end () - 4 );
+    return true;
+}
+
+} // namespace Json
@@ -0,0 +1,66 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_BASE58_H_INCLUDED
+#define RIPPLE_JSON_JSON_BASE58_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Json
+{
+
+/** \brief Token types prefixed to base58check text.
+
+    The type byte gives each kind of token its leading character, such as
+    'r' for accounts and 'n' for node public keys.
+*/
+enum TokenType : std::uint8_t
+{
+    tokenAccountId = 0,
+    tokenNodePublic = 28,
+    tokenNodePrivate = 32,
+    tokenAccountSecret = 34
+};
+
+/// \brief The 58 digits of the Ripple alphabet, from zero.
+extern char const base58Alphabet[59];
+
+/** \brief Encode bytes as base58check text in the Ripple alphabet,
+ *         appending it to \a out.
+ *
+ * The text encodes the type byte and the data, followed by the first four
+ * bytes of their double SHA-256.
+ */
+void base58CheckEncode ( std::uint8_t type, std::uint8_t const* data,
+                         std::size_t size, std::string& out );
+
+/** \brief Decode base58check text of the given type, appending the data
+ *         to \a out.
+ * \return \c true on success, \c false if the text is not base58, has
+ *         another type or a wrong checksum, in which case the contents of
+ *         \a out are unspecified.
+ */
+bool base58CheckDecode ( std::uint8_t type, const char* begin,
+                         const char* end, std::string& out );
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_base64.h>
+
+namespace Json
+{
+
+namespace {
+
+unsigned char const invalid = 0xff;
+unsigned char const space = 0xfe;
+
+char const alphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+struct DecodeTable
+{
+    unsigned char values[256];
+
+    DecodeTable ()
+    {
+        for ( auto& v : values )
+            v = invalid;
+
+        for ( int i = 0; i < 64; ++i )
+            values[static_cast<unsigned char> ( alphabet[i] )] =
+                static_cast<unsigned char> ( i );
+
+        values[' '] = values['\t'] = values['\r'] = values['\n'] = space;
+    }
+};
+
+} // namespace
+
+void
+base64Encode ( void const* data, std::size_t size, std::string& out )
+{
+    auto const* p = static_cast<const unsigned char*> ( data );
+    std::size_t at = out.size ();
+    out.resize ( at + ( size + 2 ) / 3 * 4 );
+
+    for ( ; size >= 3; size -= 3, p += 3 )
+    {
+        unsigned int const bits = ( p[0] << 16 ) | ( p[1] << 8 ) | p[2];
+        out[at++] = alphabet[bits >> 18];
+        out[at++] = alphabet[( bits >> 12 ) & 0x3f];
+        out[at++] = alphabet[( bits >> 6 ) & 0x3f];
+        out[at++] = alphabet[bits & 0x3f];
+    }
+
+    if ( size > 0 )
+    {
+        unsigned int const bits =
+            ( p[0] << 16 ) | ( size == 2 ? p[1] << 8 : 0 );
+        out[at++] = alphabet[bits >> 18];
+        out[at++] = alphabet[( bits >> 12 ) & 0x3f];
+        out[at++] = size == 2 ? alphabet[( bits >> 6 ) & 0x3f] : '=';
+        out[at++] = '=';
+    }
+}
+
+bool
+base64Decode ( const char* begin, const char* end, std::string& out )
+{
+    static DecodeTable const table;
+    auto const* p = reinterpret_cast<const unsigned char*> ( begin );
+    auto const* const last = reinterpret_cast<const unsigned char*> ( end );
+
+    out.reserve ( out.size () + ( last - p ) / 4 * 3 );
+
+    unsigned int group = 0;
+    int count = 0;
+
+    while ( p != last )
+    {
+        // Fast path: four significant characters at once.
+        if ( count == 0  &&  last - p >= 4 )
+        {
+            unsigned char const a = table.values[p[0]];
+            unsigned char const b = table.values[p[1]];
+            unsigned char const c = table.values[p[2]];
+            unsigned char const d = table.values[p[3]];
+
+            if ( ( a | b | c | d ) < 64 )
+            {
+                unsigned int const bits = ( a << 18 ) | ( b << 12 ) | ( c << 6 ) | d;
+                out += static_cast<char> ( bits >> 16 );
+                out += static_cast<char> ( bits >> 8 );
+                out += static_cast<char> ( bits );
+                p += 4;
+                continue;
+            }
+        }
+
+        unsigned char const v = table.values[*p];
+
+        if ( v == space )
+        {
+            ++p;
+            continue;
+        }
+
+        if ( v == invalid )
+            break;
+
+        group = ( group << 6 ) | v;
+        ++p;
+
+        if ( ++count == 4 )
+        {
+            out += static_cast<char> ( group >> 16 );
+            out += static_cast<char> ( group >> 8 );
+            out += static_cast<char> ( group );
+            group = 0;
+            count = 0;
+        }
+    }
+
+    // Only padding and whitespace may follow the data.
+    int padding = 0;
+
+    for ( ; p != last; ++p )
+    {
+        if ( *p == '=' )
+            ++padding;
+        else if ( table.values[*p] != space )
+            return false;
+    }
+
+    switch ( count )
+    {
+    case 0:
+        return padding == 0;
+
+    // The bits of a partial group past its last byte must be zero, or
+    // several texts, such as QQ== and QR==, would decode to one string.
+    case 2:
+        out += static_cast<char> ( group >> 4 );
+        return ( group & 0x0f ) == 0  &&  ( padding == 0  ||  padding == 2 );
+
+    case 3:
+        out += static_cast<char> ( group >> 10 );
+        out += static_cast<char> ( group >> 2 );
+        return ( group & 0x03 ) == 0  &&  ( padding == 0  ||  padding == 1 );
+
+    default:
+        return false;
+    }
+}
+
+} // namespace Json
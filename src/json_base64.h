@@ -0,0 +1,47 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_JSON_JSON_BASE64_H_INCLUDED
+#define RIPPLE_JSON_JSON_BASE64_H_INCLUDED
+
+#include <cstddef>
+#include <string>
+
+namespace Json
+{
+
+/// \brief Encode bytes as padded base64 text, appending it to \a out.
+void base64Encode ( void const* data, std::size_t size, std::string& out );
+
+/** \brief Decode base64 text, appending the bytes to \a out.
+
+    Whitespace is skipped, so text wrapped across lines, as validator
+    tokens are in configuration files, decodes directly. Padding is
+    optional at the end of the text. Unused bits in the last group must be
+    zero, so that no two texts decode to the same bytes other than through
+    whitespace and padding.
+    \return \c true on success, \c false if the text is not valid base64,
+            in which case the contents of \a out are unspecified.
+*/
+bool base64Decode ( const char* begin, const char* end, std::string& out );
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,595 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_binary_reader.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Json
+{
+
+namespace {
+
+// The same nesting limit Reader applies to JSON text.
+unsigned const nest_limit = 25;
+
+double
+halfToDouble ( std::uint64_t half )
+{
+    int const exponent = ( half >> 10 ) & 0x1f;
+    double const mantissa = double ( half & 0x3ff );
+    double value;
+
+    if ( exponent == 0 )
+        value = std::ldexp ( mantissa, -24 );
+    else if ( exponent != 31 )
+        value = std::ldexp ( mantissa + 1024, exponent - 25 );
+    else if ( mantissa == 0 )
+        value = std::numeric_limits<double>::infinity ();
+    else
+        value = std::numeric_limits<double>::quiet_NaN ();
+
+    return ( half & 0x8000 ) ? -value : value;
+}
+
+double
+floatToDouble ( std::uint64_t bits )
+{
+    std::uint32_t const narrow = static_cast<std::uint32_t> ( bits );
+    float f;
+    std::memcpy ( &f, &narrow, sizeof ( f ) );
+    return f;
+}
+
+double
+bitsToDouble ( std::uint64_t bits )
+{
+    double d;
+    std::memcpy ( &d, &bits, sizeof ( d ) );
+    return d;
+}
+
+} // namespace
+
+BinaryReader::BinaryReader ( Format format )
+    : format_ (format)
+    , begin_ (nullptr)
+    , end_ (nullptr)
+    , current_ (nullptr)
+{
+}
+
+bool
+BinaryReader::parse ( std::string const& document, Value& root )
+{
+    return parse ( document.data (), document.data () + document.size (), root );
+}
+
+bool
+BinaryReader::parse ( const char* beginDoc, const char* endDoc, Value& root )
+{
+    begin_ = reinterpret_cast<Location> ( beginDoc );
+    end_ = reinterpret_cast<Location> ( endDoc );
+    current_ = begin_;
+    errors_.clear ();
+
+    if ( !readValue ( root, 0 ) )
+        return false;
+
+    if ( !root.isArray ()  &&  !root.isObject () )
+        return addError ( "A valid JSON document must be either an array or an object value.", begin_ );
+
+    if ( current_ != end_ )
+        return addError ( "Unexpected data after the document.", current_ );
+
+    return true;
+}
+
+std::string
+BinaryReader::getFormatedErrorMessages () const
+{
+    std::string formattedMessage;
+
+    for ( auto const& error : errors_ )
+    {
+        formattedMessage += "* Offset " + std::to_string ( error.offset_ ) + "\n";
+        formattedMessage += "  " + error.message_ + "\n";
+    }
+
+    return formattedMessage;
+}
+
+bool
+BinaryReader::readValue ( Value& value, unsigned depth )
+{
+    if ( depth > nest_limit )
+        return addError ( "Syntax error: maximum nesting depth exceeded", current_ );
+
+    if ( current_ == end_ )
+        return addError ( "Unexpected end of document.", current_ );
+
+    if ( format_ == cbor )
+        return readCbor ( value, depth );
+
+    return readMessagePack ( value, depth );
+}
+
+bool
+BinaryReader::readMember ( Value& object, unsigned depth )
+{
+    Location const at = current_;
+    Value name;
+
+    if ( !readValue ( name, depth ) )
+        return false;
+
+    if ( !name.isString () )
+        return addError ( "Object member names must be strings.", at );
+
+    std::string const key = name.asString ();
+    auto const members = object.size ();
+    Value& value = object[ key ];
+
+    if ( object.size () == members )
+        return addError ( "Key '" + key + "' appears twice.", at );
+
+    return readValue ( value, depth + 1 );
+}
+
+bool
+BinaryReader::readCbor ( Value& value, unsigned depth )
+{
+    Location const at = current_;
+    unsigned char const initial = *current_++;
+    unsigned const major = initial >> 5;
+    unsigned const minor = initial & 0x1f;
+    std::uint64_t argument = 0;
+
+    switch ( major )
+    {
+    case 0:
+    case 1:
+        if ( !readCborArgument ( initial, argument ) )
+            return false;
+
+        // A negative integer encodes -1 - argument.
+        if ( major == 1  &&  argument == std::numeric_limits<std::uint64_t>::max () )
+            return addError ( "Integer exceeds the allowable range.", at );
+
+        return setInteger ( value, major == 1, major == 1 ? argument + 1 : argument ) ||
+            addError ( "Integer exceeds the allowable range.", at );
+
+    case 2:
+        return addError ( "Byte strings have no JSON equivalent.", at );
+
+    case 3:
+    {
+        std::string s;
+
+        if ( !readCborString ( initial, s ) )
+            return false;
+
+        value = s;
+        return true;
+    }
+
+    case 4:
+        value = Value ( arrayValue );
+
+        if ( minor == 31 ) // indefinite length
+        {
+            for ( Value::UInt index = 0; ; ++index )
+            {
+                if ( current_ == end_ )
+                    return addError ( "Unexpected end of document.", current_ );
+
+                if ( *current_ == 0xff )
+                {
+                    ++current_;
+                    return true;
+                }
+
+                if ( !readValue ( value[index], depth + 1 ) )
+                    return false;
+            }
+        }
+
+        if ( !readCborArgument ( initial, argument ) )
+            return false;
+
+        for ( std::uint64_t index = 0; index < argument; ++index )
+        {
+            if ( index > Value::maxUInt )
+                return addError ( "Array is too large.", at );
+
+            if ( !readValue ( value[ Value::UInt ( index ) ], depth + 1 ) )
+                return false;
+        }
+
+        return true;
+
+    case 5:
+        value = Value ( objectValue );
+
+        if ( minor == 31 ) // indefinite length
+        {
+            while ( true )
+            {
+                if ( current_ == end_ )
+                    return addError ( "Unexpected end of document.", current_ );
+
+                if ( *current_ == 0xff )
+                {
+                    ++current_;
+                    return true;
+                }
+
+                if ( !readMember ( value, depth ) )
+                    return false;
+            }
+        }
+
+        if ( !readCborArgument ( initial, argument ) )
+            return false;
+
+        for ( std::uint64_t index = 0; index < argument; ++index )
+        {
+            if ( !readMember ( value, depth ) )
+                return false;
+        }
+
+        return true;
+
+    case 6:
+        // Tags only annotate the item that follows, which is read as is.
+        // Chained tags are skipped here rather than recursed through.
+        if ( !readCborArgument ( initial, argument ) )
+            return false;
+
+        while ( current_ != end_  &&  ( *current_ >> 5 ) == 6 )
+        {
+            unsigned char const tag = *current_++;
+
+            if ( !readCborArgument ( tag, argument ) )
+                return false;
+        }
+
+        return readValue ( value, depth );
+
+    default:
+        break;
+    }
+
+    switch ( minor )
+    {
+    case 20:
+        value = false;
+        return true;
+
+    case 21:
+        value = true;
+        return true;
+
+    case 22:
+        value = Value ();
+        return true;
+
+    case 25:
+        if ( !readBigEndian ( 2, argument ) )
+            return false;
+
+        return setReal ( value, halfToDouble ( argument ), at );
+
+    case 26:
+        if ( !readBigEndian ( 4, argument ) )
+            return false;
+
+        return setReal ( value, floatToDouble ( argument ), at );
+
+    case 27:
+        if ( !readBigEndian ( 8, argument ) )
+            return false;
+
+        return setReal ( value, bitsToDouble ( argument ), at );
+
+    default:
+        return addError ( "Simple value has no JSON equivalent.", at );
+    }
+}
+
+bool
+BinaryReader::readCborArgument ( unsigned char initial, std::uint64_t& argument )
+{
+    unsigned const minor = initial & 0x1f;
+
+    if ( minor < 24 )
+    {
+        argument = minor;
+        return true;
+    }
+
+    if ( minor > 27 )
+        return addError ( "Invalid length or value encoding.", current_ - 1 );
+
+    return readBigEndian ( std::size_t ( 1 ) << ( minor - 24 ), argument );
+}
+
+bool
+BinaryReader::readCborString ( unsigned char initial, std::string& s )
+{
+    if ( ( initial & 0x1f ) != 31 )
+    {
+        std::uint64_t size;
+        return readCborArgument ( initial, size )  &&  readBytes ( size, s );
+    }
+
+    // An indefinite length string is a series of definite length chunks.
+    while ( true )
+    {
+        if ( current_ == end_ )
+            return addError ( "Unexpected end of document.", current_ );
+
+        unsigned char const chunk = *current_++;
+
+        if ( chunk == 0xff )
+            return true;
+
+        if ( ( chunk >> 5 ) != 3  ||  ( chunk & 0x1f ) == 31 )
+            return addError ( "Invalid chunk in indefinite length string.", current_ - 1 );
+
+        std::uint64_t size;
+        std::string part;
+
+        if ( !readCborArgument ( chunk, size )  ||  !readBytes ( size, part ) )
+            return false;
+
+        s += part;
+    }
+}
+
+bool
+BinaryReader::readMessagePack ( Value& value, unsigned depth )
+{
+    Location const at = current_;
+    unsigned char const initial = *current_++;
+    std::uint64_t argument = 0;
+    std::size_t count = 0;
+    bool isMap = false;
+
+    if ( initial <= 0x7f ) // positive fixint
+        return setInteger ( value, false, initial );
+
+    if ( initial >= 0xe0 ) // negative fixint
+        return setInteger ( value, true, 0x100 - initial );
+
+    if ( ( initial & 0xe0 ) == 0xa0 ) // fixstr
+    {
+        std::string s;
+
+        if ( !readBytes ( initial & 0x1f, s ) )
+            return false;
+
+        value = s;
+        return true;
+    }
+
+    if ( ( initial & 0xf0 ) == 0x80 ) // fixmap
+    {
+        isMap = true;
+        count = initial & 0x0f;
+    }
+    else if ( ( initial & 0xf0 ) == 0x90 ) // fixarray
+    {
+        count = initial & 0x0f;
+    }
+    else
+    {
+        switch ( initial )
+        {
+        case 0xc0:
+            value = Value ();
+            return true;
+
+        case 0xc2:
+            value = false;
+            return true;
+
+        case 0xc3:
+            value = true;
+            return true;
+
+        case 0xca:
+            if ( !readBigEndian ( 4, argument ) )
+                return false;
+
+            return setReal ( value, floatToDouble ( argument ), at );
+
+        case 0xcb:
+            if ( !readBigEndian ( 8, argument ) )
+                return false;
+
+            return setReal ( value, bitsToDouble ( argument ), at );
+
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+            if ( !readBigEndian ( std::size_t ( 1 ) << ( initial - 0xcc ), argument ) )
+                return false;
+
+            return setInteger ( value, false, argument ) ||
+                addError ( "Integer exceeds the allowable range.", at );
+
+        case 0xd0:
+        case 0xd1:
+        case 0xd2:
+        case 0xd3:
+        {
+            std::size_t const bytes = std::size_t ( 1 ) << ( initial - 0xd0 );
+
+            if ( !readBigEndian ( bytes, argument ) )
+                return false;
+
+            // Sign extend to 64 bits.
+            unsigned const shift = unsigned ( 64 - 8 * bytes );
+            std::int64_t const i = static_cast<std::int64_t> ( argument << shift ) >> shift;
+
+            bool const ok = ( i < 0 ) ?
+                setInteger ( value, true, 0 - std::uint64_t ( i ) ) :
+                setInteger ( value, false, std::uint64_t ( i ) );
+
+            return ok  ||  addError ( "Integer exceeds the allowable range.", at );
+        }
+
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+        {
+            std::string s;
+
+            if ( !readBigEndian ( std::size_t ( 1 ) << ( initial - 0xd9 ), argument )  ||
+                    !readBytes ( argument, s ) )
+                return false;
+
+            value = s;
+            return true;
+        }
+
+        case 0xdc:
+        case 0xdd:
+            if ( !readBigEndian ( initial == 0xdc ? 2 : 4, argument ) )
+                return false;
+
+            count = argument;
+            break;
+
+        case 0xde:
+        case 0xdf:
+            if ( !readBigEndian ( initial == 0xde ? 2 : 4, argument ) )
+                return false;
+
+            isMap = true;
+            count = argument;
+            break;
+
+        default:
+            return addError ( "Binary and extension types have no JSON equivalent.", at );
+        }
+    }
+
+    if ( isMap )
+    {
+        value = Value ( objectValue );
+
+        for ( std::size_t index = 0; index < count; ++index )
+        {
+            if ( !readMember ( value, depth ) )
+                return false;
+        }
+    }
+    else
+    {
+        value = Value ( arrayValue );
+
+        for ( std::size_t index = 0; index < count; ++index )
+        {
+            if ( !readValue ( value[ Value::UInt ( index ) ], depth + 1 ) )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+BinaryReader::readBigEndian ( std::size_t bytes, std::uint64_t& result )
+{
+    if ( std::size_t ( end_ - current_ ) < bytes )
+        return addError ( "Unexpected end of document.", current_ );
+
+    result = 0;
+
+    while ( bytes-- )
+        result = ( result << 8 ) | *current_++;
+
+    return true;
+}
+
+bool
+BinaryReader::readBytes ( std::size_t size, std::string& s )
+{
+    if ( std::size_t ( end_ - current_ ) < size )
+        return addError ( "Unexpected end of document.", current_ );
+
+    s.assign ( reinterpret_cast<const char*> ( current_ ), size );
+    current_ += size;
+    return true;
+}
+
+bool
+BinaryReader::setInteger ( Value& value, bool negative, std::uint64_t magnitude )
+{
+    // Mirror Reader: integers are signed when they fit, otherwise unsigned.
+    if ( negative )
+    {
+        if ( magnitude > std::uint64_t ( Value::maxInt ) + 1 )
+            return false;
+
+        value = static_cast<Value::Int> ( -static_cast<std::int64_t> ( magnitude ) );
+    }
+    else if ( magnitude <= std::uint64_t ( Value::maxInt ) )
+    {
+        value = static_cast<Value::Int> ( magnitude );
+    }
+    else if ( magnitude <= Value::maxUInt )
+    {
+        value = static_cast<Value::UInt> ( magnitude );
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
+}
+
+bool
+BinaryReader::setReal ( Value& value, double real, Location at )
+{
+    // JSON text has no way to write these, so Reader never produces them.
+    if ( !std::isfinite ( real ) )
+        return addError ( "NaN and infinite numbers have no JSON equivalent.", at );
+
+    value = real;
+    return true;
+}
+
+bool
+BinaryReader::addError ( std::string const& message, Location at )
+{
+    ErrorInfo info;
+    info.offset_ = at - begin_;
+    info.message_ = message;
+    errors_.push_back ( info );
+    return false;
+}
+
+} // namespace Json
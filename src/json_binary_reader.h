@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_JSON_JSON_BINARY_READER_H_INCLUDED
+#define RIPPLE_JSON_JSON_BINARY_READER_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Json
+{
+
+/** \brief Unserialize a CBOR or MessagePack document into a Value.
+
+    Services that exchange data among themselves can use a binary encoding
+    instead of JSON text and still obtain the same Value. BinaryReader
+    applies Reader's rules: the root must be an array or an object, numbers
+    must fit in a Value's 32-bit integers or a double, member names must be
+    strings and may not repeat, and nesting is limited to the same depth.
+    Data with no JSON equivalent, such as byte strings, extension types,
+    NaN or infinite numbers, is rejected.
+*/
+class BinaryReader
+{
+public:
+    enum Format
+    {
+        cbor,           ///< RFC 7049 Concise Binary Object Representation
+        messagePack     ///< https://msgpack.org
+    };
+
+    explicit BinaryReader ( Format format );
+
+    /** \brief Read a Value from a binary document.
+     * \param root [out] Contains the root value of the document if it was
+     *             successfully parsed.
+     * \return \c true if the document was successfully parsed, \c false if an error occurred.
+     */
+    bool parse ( const char* beginDoc, const char* endDoc, Value& root );
+
+    bool parse ( std::string const& document, Value& root );
+
+    /** \brief Returns a user friendly string that list errors in the parsed document.
+     * \return Formatted error message with the list of errors with their byte
+     *         offset in the parsed document. An empty string is returned if
+     *         no error occurred during parsing.
+     */
+    std::string getFormatedErrorMessages () const;
+
+private:
+    using Location = const unsigned char*;
+
+    class ErrorInfo
+    {
+    public:
+        std::size_t offset_;
+        std::string message_;
+    };
+
+    bool readCbor ( Value& value, unsigned depth );
+    bool readCborArgument ( unsigned char initial, std::uint64_t& argument );
+    bool readCborString ( unsigned char initial, std::string& s );
+    bool readMessagePack ( Value& value, unsigned depth );
+    bool readValue ( Value& value, unsigned depth );
+    bool readMember ( Value& object, unsigned depth );
+    bool readBigEndian ( std::size_t bytes, std::uint64_t& result );
+    bool readBytes ( std::size_t size, std::string& s );
+    bool setInteger ( Value& value, bool negative, std::uint64_t magnitude );
+    bool setReal ( Value& value, double real, Location at );
+    bool addError ( std::string const& message, Location at );
+
+    Format format_;
+    Location begin_;
+    Location end_;
+    Location current_;
+    std::vector<ErrorInfo> errors_;
+};
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_BINDING_H_INCLUDED
+#define RIPPLE_JSON_JSON_BINDING_H_INCLUDED
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Json
+{
+
+/** \brief Describes one member of a struct bound to a JSON object.
+
+    \a name is the JSON member name and \a member the data member it is
+    stored in. A member that is not \a optional must be present in every
+    object read into the struct.
+*/
+template <class Struct, class Member>
+struct Field
+{
+    const char* name;
+    Member Struct::* member;
+    bool optional;
+};
+
+template <class Struct, class Member>
+constexpr
+Field<Struct, Member>
+field ( const char* name, Member Struct::* member, bool optional = false )
+{
+    return Field<Struct, Member> { name, member, optional };
+}
+
+/** \brief The field table binding a struct to a JSON object.
+
+    Specialize for each bound struct, with a static \c fields() returning a
+    std::tuple of Field built with field():
+
+    \code
+    template <>
+    struct Binding<Manifest>
+    {
+        static constexpr auto fields ()
+        {
+            return std::make_tuple (
+                field ( "PublicKey", &Manifest::publicKey ),
+                field ( "Sequence", &Manifest::sequence ),
+                field ( "Domain", &Manifest::domain, true ) );
+        }
+    };
+    \endcode
+
+    The table is a compile-time constant, so code reading or writing the
+    struct is unrolled over its members with no lookup structures built at
+    run time.
+*/
+template <class T>
+struct Binding;
+
+/// \brief Whether \a T has a Binding.
+template <class T, class = void>
+struct isBound
+    : std::false_type
+{
+};
+
+template <class T>
+struct isBound<T, decltype ( (void) Binding<T>::fields (), void () )>
+    : std::true_type
+{
+};
+
+/// \brief Number of fields in the Binding of \a T.
+template <class T>
+constexpr
+std::size_t
+fieldCount ()
+{
+    return std::tuple_size<decltype ( Binding<T>::fields () )>::value;
+}
+
+namespace detail {
+
+template <class Fields, class Function, std::size_t... I>
+void
+forEachField ( Fields const& fields, Function&& f, std::index_sequence<I...> )
+{
+    using expand = int[];
+    (void) expand { 0, ( f ( std::get<I> ( fields ), I ), 0 )... };
+}
+
+} // namespace detail
+
+/** \brief Call \a f ( field, index ) for each field of \a T, in table order.
+*/
+template <class T, class Function>
+void
+forEachField ( Function&& f )
+{
+    detail::forEachField ( Binding<T>::fields (), f,
+        std::make_index_sequence<fieldCount<T> ()> () );
+}
+
+} // namespace Json
+
+#endif
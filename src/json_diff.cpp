@@ -0,0 +1,518 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_diff.h>
+#include <json_reader.h>
+#include <json_structural_index.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <set>
+#include <vector>
+
+namespace Json
+{
+
+namespace {
+
+// The same nesting limit Reader applies.
+std::size_t const nest_limit = 25;
+
+std::size_t const npos = std::size_t ( -1 );
+
+bool
+isSpace ( char c )
+{
+    return c == ' '  ||  c == '\t'  ||  c == '\r'  ||  c == '\n';
+}
+
+// Append one reference token to a JSON Pointer (RFC 6901).
+std::string
+appendPath ( std::string const& path, std::string const& token )
+{
+    std::string result = path;
+    result += '/';
+
+    for ( char c : token )
+    {
+        if ( c == '~' )
+            result += "~0";
+        else if ( c == '/' )
+            result += "~1";
+        else
+            result += c;
+    }
+
+    return result;
+}
+
+void
+addOperation ( Value& patch, const char* op, std::string const& path )
+{
+    Value& operation = patch[ patch.size () ];
+    operation["op"] = op;
+    operation["path"] = path;
+}
+
+void
+addOperation ( Value& patch, const char* op, std::string const& path,
+               Value const& value )
+{
+    addOperation ( patch, op, path );
+    patch[ patch.size () - 1 ]["value"] = value;
+}
+
+// Compare two parsed values.
+void
+diffValues ( Value const& from, Value const& to,
+             std::string const& path, Value& patch )
+{
+    if ( from.isObject ()  &&  to.isObject () )
+    {
+        for ( auto it = from.begin (); it != from.end (); ++it )
+        {
+            std::string const name = it.memberName ();
+
+            if ( to.isMember ( name ) )
+                diffValues ( *it, to[name], appendPath ( path, name ), patch );
+            else
+                addOperation ( patch, "remove", appendPath ( path, name ) );
+        }
+
+        for ( auto it = to.begin (); it != to.end (); ++it )
+        {
+            std::string const name = it.memberName ();
+
+            if ( !from.isMember ( name ) )
+                addOperation ( patch, "add", appendPath ( path, name ), *it );
+        }
+    }
+    else if ( from.isArray ()  &&  to.isArray () )
+    {
+        Value::UInt const common = std::min ( from.size (), to.size () );
+
+        for ( Value::UInt i = 0; i < common; ++i )
+            diffValues ( from[i], to[i],
+                appendPath ( path, std::to_string ( i ) ), patch );
+
+        // Remove from the back so earlier indices stay valid.
+        for ( Value::UInt i = from.size (); i > common; --i )
+            addOperation ( patch, "remove",
+                appendPath ( path, std::to_string ( i - 1 ) ) );
+
+        for ( Value::UInt i = common; i < to.size (); ++i )
+            addOperation ( patch, "add",
+                appendPath ( path, std::to_string ( i ) ), to[i] );
+    }
+    else if ( from != to )
+    {
+        addOperation ( patch, "replace", path, to );
+    }
+}
+
+// The text of one value in a document, with whitespace trimmed, and the
+// position in the document's index of the first entry within it.
+struct Node
+{
+    const char* begin;
+    const char* end;
+    std::size_t first;
+};
+
+struct Member
+{
+    std::string name;
+    Node value;
+};
+
+class Document
+{
+public:
+    Document ( const char* begin, const char* end )
+        : begin_ (begin)
+        , end_ (end)
+        , index_ (begin, end)
+        , close_ (index_.size (), npos)
+        , depth_ (0)
+    {
+        // Match each bracket with the one closing it, so a child container
+        // is stepped over at once rather than scanned at every level.
+        std::vector<std::size_t> open;
+
+        for ( std::size_t i = 0; i < index_.size (); ++i )
+        {
+            switch ( begin_[index_[i]] )
+            {
+            case '{':
+            case '[':
+                open.push_back ( i );
+                depth_ = std::max ( depth_, open.size () );
+                break;
+
+            case '}':
+            case ']':
+                if ( !open.empty () )
+                {
+                    close_[open.back ()] = i;
+                    open.pop_back ();
+                }
+                break;
+            }
+        }
+    }
+
+    // The greatest number of brackets open at once.
+    std::size_t depth () const
+    {
+        return depth_;
+    }
+
+    bool hasComments () const
+    {
+        for ( auto const offset : index_ )
+        {
+            if ( begin_[offset] == '/' )
+                return true;
+        }
+
+        return false;
+    }
+
+    Node root () const
+    {
+        return trim ( begin_, end_, 0 );
+    }
+
+    // The children of an object or array, or false if the brackets do not
+    // balance.
+    bool children ( Node const& node,
+                    std::vector<Node>& keys, std::vector<Node>& values ) const
+    {
+        keys.clear ();
+        values.clear ();
+
+        const char* start = node.begin + 1;
+        std::size_t startPos = node.first + 1;
+
+        for ( std::size_t i = node.first + 1; i < index_.size (); ++i )
+        {
+            const char* const p = begin_ + index_[i];
+
+            switch ( *p )
+            {
+            case '{':
+            case '[':
+                if ( close_[i] == npos )
+                    return false;
+
+                i = close_[i];
+                break;
+
+            case '}':
+            case ']':
+            {
+                Node const last = trim ( start, p, startPos );
+
+                if ( last.begin != last.end  ||  !values.empty () )
+                    values.push_back ( last );
+
+                return p + 1 == node.end;
+            }
+
+            case ':':
+                keys.push_back ( trim ( start, p, startPos ) );
+                start = p + 1;
+                startPos = i + 1;
+                break;
+
+            case ',':
+                values.push_back ( trim ( start, p, startPos ) );
+                start = p + 1;
+                startPos = i + 1;
+                break;
+            }
+        }
+
+        return false;
+    }
+
+private:
+    Node trim ( const char* begin, const char* end, std::size_t first ) const
+    {
+        while ( begin != end  &&  isSpace ( *begin ) )
+            ++begin;
+
+        while ( end != begin  &&  isSpace ( end[-1] ) )
+            --end;
+
+        return Node { begin, end, first };
+    }
+
+    const char* begin_;
+    const char* end_;
+    StructuralIndex index_;
+    // For each opening bracket, the index entry of its closing bracket.
+    std::vector<std::size_t> close_;
+    std::size_t depth_;
+};
+
+bool
+identical ( Node const& a, Node const& b )
+{
+    std::size_t const size = a.end - a.begin;
+    return size == std::size_t ( b.end - b.begin )  &&
+        std::memcmp ( a.begin, b.begin, size ) == 0;
+}
+
+bool
+isContainer ( Node const& node, char open )
+{
+    return node.begin != node.end  &&  *node.begin == open;
+}
+
+// Compare two documents through their structural indexes. Returns false
+// if any part that had to be parsed was invalid.
+class TextDiff
+{
+public:
+    TextDiff ( Document const& from, Document const& to, Value& patch )
+        : from_ (from)
+        , to_ (to)
+        , patch_ (patch)
+    {
+    }
+
+    bool diff ( Node const& from, Node const& to, std::string const& path )
+    {
+        if ( identical ( from, to ) )
+            return true;
+
+        if ( isContainer ( from, '{' )  &&  isContainer ( to, '{' ) )
+            return diffObjects ( from, to, path );
+
+        if ( isContainer ( from, '[' )  &&  isContainer ( to, '[' ) )
+            return diffArrays ( from, to, path );
+
+        Value a;
+        Value b;
+
+        if ( !parse ( from, a )  ||  !parse ( to, b ) )
+            return false;
+
+        diffValues ( a, b, path, patch_ );
+        return true;
+    }
+
+private:
+    bool parse ( Node const& node, Value& value )
+    {
+        return reader_.parseValue ( node.begin, node.end, value );
+    }
+
+    bool members ( Document const& document, Node const& node,
+                   std::vector<Member>& result )
+    {
+        if ( !document.children ( node, keys_, values_ )  ||
+                keys_.size () != values_.size () )
+            return false;
+
+        result.clear ();
+        result.reserve ( keys_.size () );
+        names_.clear ();
+        Value name;
+
+        for ( std::size_t i = 0; i < keys_.size (); ++i )
+        {
+            if ( !parse ( keys_[i], name )  ||  !name.isString () )
+                return false;
+
+            // Reader rejects repeated member names.
+            if ( !names_.insert ( name.asString () ).second )
+                return false;
+
+            result.push_back ( Member { name.asString (), values_[i] } );
+        }
+
+        return true;
+    }
+
+    bool diffObjects ( Node const& from, Node const& to,
+                       std::string const& path )
+    {
+        std::vector<Member> a;
+        std::vector<Member> b;
+
+        if ( !members ( from_, from, a )  ||  !members ( to_, to, b ) )
+            return false;
+
+        std::map<std::string, Node const*> lookup;
+
+        for ( auto const& member : b )
+            lookup.emplace ( member.name, &member.value );
+
+        for ( auto const& member : a )
+        {
+            auto const it = lookup.find ( member.name );
+
+            if ( it == lookup.end () )
+            {
+                addOperation ( patch_, "remove",
+                    appendPath ( path, member.name ) );
+            }
+            else if ( !diff ( member.value, *it->second,
+                    appendPath ( path, member.name ) ) )
+            {
+                return false;
+            }
+        }
+
+        lookup.clear ();
+
+        for ( auto const& member : a )
+            lookup.emplace ( member.name, &member.value );
+
+        for ( auto const& member : b )
+        {
+            if ( lookup.count ( member.name ) )
+                continue;
+
+            Value value;
+
+            if ( !parse ( member.value, value ) )
+                return false;
+
+            addOperation ( patch_, "add",
+                appendPath ( path, member.name ), value );
+        }
+
+        return true;
+    }
+
+    bool diffArrays ( Node const& from, Node const& to,
+                      std::string const& path )
+    {
+        std::vector<Node> a;
+        std::vector<Node> b;
+
+        if ( !from_.children ( from, keys_, a )  ||  !keys_.empty ()  ||
+                !to_.children ( to, keys_, b )  ||  !keys_.empty () )
+            return false;
+
+        std::size_t const common = std::min ( a.size (), b.size () );
+
+        for ( std::size_t i = 0; i < common; ++i )
+        {
+            if ( !diff ( a[i], b[i], appendPath ( path, std::to_string ( i ) ) ) )
+                return false;
+        }
+
+        // Remove from the back so earlier indices stay valid.
+        for ( std::size_t i = a.size (); i > common; --i )
+            addOperation ( patch_, "remove",
+                appendPath ( path, std::to_string ( i - 1 ) ) );
+
+        for ( std::size_t i = common; i < b.size (); ++i )
+        {
+            Value value;
+
+            if ( !parse ( b[i], value ) )
+                return false;
+
+            addOperation ( patch_, "add",
+                appendPath ( path, std::to_string ( i ) ), value );
+        }
+
+        return true;
+    }
+
+    Document const& from_;
+    Document const& to_;
+    Value& patch_;
+    Reader reader_;
+    std::vector<Node> keys_;
+    std::vector<Node> values_;
+    std::set<std::string> names_;
+};
+
+} // namespace
+
+bool
+Differ::diff ( std::string const& from, std::string const& to, Value& patch )
+{
+    return diff ( from.data (), from.data () + from.size (),
+        to.data (), to.data () + to.size (), patch );
+}
+
+bool
+Differ::diff ( const char* beginFrom, const char* endFrom,
+               const char* beginTo, const char* endTo,
+               Value& patch )
+{
+    errors_.clear ();
+    patch = Value ( arrayValue );
+
+    Document const from ( beginFrom, endFrom );
+    Document const to ( beginTo, endTo );
+
+    // Documents nested deeper than Reader allows are parsed in full so the
+    // error is reported, which also bounds the recursion below.
+    if ( !from.hasComments ()  &&  !to.hasComments ()  &&
+            from.depth () <= nest_limit  &&  to.depth () <= nest_limit )
+    {
+        Node const a = from.root ();
+        Node const b = to.root ();
+
+        // Only documents rooted in an object or array are valid.
+        bool const rooted =
+            ( isContainer ( a, '{' )  ||  isContainer ( a, '[' ) )  &&
+            ( isContainer ( b, '{' )  ||  isContainer ( b, '[' ) );
+
+        if ( rooted  &&  TextDiff ( from, to, patch ).diff ( a, b, "" ) )
+            return true;
+
+        patch = Value ( arrayValue );
+    }
+
+    // Parse both documents in full, because they hold comments or nest too
+    // deeply, or to report errors against the whole document.
+    Reader reader;
+    Value a;
+    Value b;
+
+    if ( !reader.parse ( beginFrom, endFrom, a ) )
+        errors_ += "In the first document:\n" + reader.getFormatedErrorMessages ();
+
+    if ( !reader.parse ( beginTo, endTo, b ) )
+        errors_ += "In the second document:\n" + reader.getFormatedErrorMessages ();
+
+    if ( !errors_.empty () )
+        return false;
+
+    diffValues ( a, b, "", patch );
+    return true;
+}
+
+std::string
+Differ::getFormatedErrorMessages () const
+{
+    return errors_;
+}
+
+} // namespace Json
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_JSON_JSON_DIFF_H_INCLUDED
+#define RIPPLE_JSON_JSON_DIFF_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <string>
+
+namespace Json
+{
+
+/** \brief Compute a JSON Patch between two documents.
+
+    The patch is an array of RFC 6902 operations ("add", "remove" and
+    "replace") that turns the first document into the second.
+
+    The documents are compared structurally through a StructuralIndex of
+    each, without building a Value for either. Subtrees whose text is
+    byte-for-byte identical are skipped without being parsed; only the
+    members and elements that differ are parsed, to compare them and to
+    supply the values of the patch. For large documents that are mostly
+    unchanged this is far cheaper than parsing both and walking the trees.
+
+    Documents containing comments, or nested more deeply than Reader
+    allows, are parsed in full and compared as values, giving the same
+    patch or Reader's errors.
+
+    Because identical text is never parsed, it is not validated either.
+    A document is checked only where it differs from the other one: the
+    values that are parsed, and the member names of the objects that are
+    compared. Errors in text common to both documents, such as a misspelt
+    literal or a repeated member name in an unchanged object, go
+    unnoticed. Parse the documents with Reader first when they are not
+    known to be valid.
+*/
+class Differ
+{
+public:
+    /** \brief Compute the patch turning \a from into \a to.
+     * \param patch [out] The array of operations, empty if the documents
+     *        are equal.
+     * \return \c true on success, \c false if a part of either document
+     *         that differs from the other could not be parsed.
+     */
+    bool diff ( std::string const& from, std::string const& to, Value& patch );
+
+    bool diff ( const char* beginFrom, const char* endFrom,
+                const char* beginTo, const char* endTo,
+                Value& patch );
+
+    /** \brief Returns a user friendly string that list errors in the
+     *         documents, each prefixed by the document it was found in.
+     */
+    std::string getFormatedErrorMessages () const;
+
+private:
+    std::string errors_;
+};
+
+} // namespace Json
+
+#endif
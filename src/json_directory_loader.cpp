@@ -0,0 +1,151 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_directory_loader.h>
+#include <json_reader.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace Json
+{
+
+namespace {
+
+bool
+readFile ( std::string const& path, std::string& buffer, std::string& error )
+{
+    std::FILE* file = std::fopen ( path.c_str (), "rb" );
+
+    if ( !file )
+    {
+        error = "Unable to open file.";
+        return false;
+    }
+
+    buffer.clear ();
+    char chunk[64 * 1024];
+    std::size_t count;
+
+    while ( ( count = std::fread ( chunk, 1, sizeof ( chunk ), file ) ) > 0 )
+        buffer.append ( chunk, count );
+
+    bool const ok = !std::ferror ( file );
+    std::fclose ( file );
+
+    if ( !ok )
+        error = "Unable to read file.";
+
+    return ok;
+}
+
+} // namespace
+
+DirectoryLoader::DirectoryLoader ( unsigned threads )
+    : threads_ (threads)
+{
+    if ( threads_ == 0 )
+        threads_ = std::max ( std::thread::hardware_concurrency (), 1u );
+}
+
+bool
+DirectoryLoader::load ( std::string const& directory, Results& results,
+                        std::string const& extension )
+{
+    namespace fs = boost::filesystem;
+
+    errors_.clear ();
+    results.clear ();
+
+    std::vector<std::string> paths;
+    boost::system::error_code ec;
+
+    for ( fs::directory_iterator it ( directory, ec ), end;
+            !ec  &&  it != end; it.increment ( ec ) )
+    {
+        if ( !fs::is_regular_file ( it->status () ) )
+            continue;
+
+        std::string const path = it->path ().string ();
+
+        if ( path.size () >= extension.size ()  &&
+                path.compare ( path.size () - extension.size (),
+                    extension.size (), extension ) == 0 )
+            paths.push_back ( path );
+    }
+
+    if ( ec )
+    {
+        errors_ = "Unable to list '" + directory + "': " + ec.message () + "\n";
+        return false;
+    }
+
+    // Files vary in size, so threads take the next file as they finish
+    // rather than a fixed share.
+    std::vector<Result> loaded ( paths.size () );
+    std::atomic<std::size_t> next ( 0 );
+
+    auto work = [&] ()
+    {
+        Reader reader;
+        std::string buffer;
+
+        for ( std::size_t i = next++; i < paths.size (); i = next++ )
+        {
+            Result& result = loaded[i];
+
+            if ( !readFile ( paths[i], buffer, result.errors ) )
+                continue;
+
+            if ( !reader.parse ( buffer.data (),
+                    buffer.data () + buffer.size (), result.value ) )
+                result.errors = reader.getFormatedErrorMessages ();
+        }
+    };
+
+    unsigned const threads = static_cast<unsigned> ( std::min<std::size_t> (
+        threads_, std::max<std::size_t> ( paths.size (), 1 ) ) );
+    std::vector<std::thread> workers;
+    workers.reserve ( threads - 1 );
+
+    for ( unsigned t = 1; t < threads; ++t )
+        workers.emplace_back ( work );
+
+    work ();
+
+    for ( auto& worker : workers )
+        worker.join ();
+
+    for ( std::size_t i = 0; i < paths.size (); ++i )
+        results.emplace ( paths[i], std::move ( loaded[i] ) );
+
+    return true;
+}
+
+std::string
+DirectoryLoader::getFormatedErrorMessages () const
+{
+    return errors_;
+}
+
+} // namespace Json
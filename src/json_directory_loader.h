@@ -0,0 +1,78 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_DIRECTORY_LOADER_H_INCLUDED
+#define RIPPLE_JSON_JSON_DIRECTORY_LOADER_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <map>
+#include <string>
+
+namespace Json
+{
+
+/** \brief Parse every JSON file in a directory concurrently.
+
+    Fleet tooling reads directories holding thousands of small key and
+    manifest files. Reading and parsing them one after another leaves the
+    time dominated by per-file system call latency. DirectoryLoader hands
+    the files out to a pool of threads, each of which reads into a reused
+    buffer and parses with a reused Reader, so many reads are in flight at
+    once and the total time approaches what the disk can deliver.
+*/
+class DirectoryLoader
+{
+public:
+    /// \brief The outcome of loading one file.
+    struct Result
+    {
+        Value value;            ///< The parsed document
+        std::string errors;     ///< Empty if the file was read and parsed
+    };
+
+    /// \brief Results keyed by the path of each file.
+    using Results = std::map<std::string, Result>;
+
+    /** \brief Create a loader that uses \a threads threads.
+     * Zero means one thread per hardware thread.
+     */
+    explicit DirectoryLoader ( unsigned threads = 0 );
+
+    /** \brief Load every regular file in \a directory whose name ends
+     *         with \a extension. Subdirectories are not searched.
+     * \param results [out] One entry per file, including those that could
+     *        not be read or parsed.
+     * \return \c true if the directory could be listed, \c false otherwise.
+     */
+    bool load ( std::string const& directory, Results& results,
+                std::string const& extension = ".json" );
+
+    /** \brief Returns a user friendly message describing why the directory
+     *         could not be listed, or an empty string.
+     */
+    std::string getFormatedErrorMessages () const;
+
+private:
+    unsigned threads_;
+    std::string errors_;
+};
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,302 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_document_hash.h>
+#include <algorithm>
+#include <cstring>
+
+namespace Json
+{
+
+namespace {
+
+inline
+std::uint64_t
+rotl ( std::uint64_t x, int r )
+{
+    return ( x << r ) | ( x >> ( 64 - r ) );
+}
+
+inline
+std::uint64_t
+fmix ( std::uint64_t k )
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdull;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ull;
+    k ^= k >> 33;
+    return k;
+}
+
+inline
+std::uint64_t
+load ( const unsigned char* p, std::size_t n )
+{
+    std::uint64_t k = 0;
+
+    while ( n-- )
+        k = ( k << 8 ) | p[n];
+
+    return k;
+}
+
+std::uint64_t const c1 = 0x87c37b91114253d5ull;
+std::uint64_t const c2 = 0x4cf5ad432745937full;
+
+// MurmurHash3_x64_128 by Austin Appleby, placed in the public domain, split
+// into its block and tail steps so that a string can be hashed in pieces.
+// The tag seeds the hash and keeps values of different types from
+// colliding.
+inline
+void
+mixBlock ( std::uint64_t& h1, std::uint64_t& h2, const unsigned char* block )
+{
+    std::uint64_t k1 = load ( block, 8 );
+    std::uint64_t k2 = load ( block + 8, 8 );
+
+    k1 *= c1; k1 = rotl ( k1, 31 ); k1 *= c2; h1 ^= k1;
+    h1 = rotl ( h1, 27 ); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+    k2 *= c2; k2 = rotl ( k2, 33 ); k2 *= c1; h2 ^= k2;
+    h2 = rotl ( h2, 31 ); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+}
+
+// Mix in the last length % 16 bytes and finalize.
+DocumentHash
+mixTail ( std::uint64_t h1, std::uint64_t h2, const unsigned char* tail,
+          std::uint64_t length )
+{
+    std::size_t const rest = length & 15;
+
+    if ( rest > 8 )
+    {
+        std::uint64_t k2 = load ( tail + 8, rest - 8 );
+        k2 *= c2; k2 = rotl ( k2, 33 ); k2 *= c1; h2 ^= k2;
+    }
+
+    if ( rest > 0 )
+    {
+        std::uint64_t k1 = load ( tail, rest < 8 ? rest : 8 );
+        k1 *= c1; k1 = rotl ( k1, 31 ); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= length;
+    h2 ^= length;
+    h1 += h2;
+    h2 += h1;
+    h1 = fmix ( h1 );
+    h2 = fmix ( h2 );
+    h1 += h2;
+    h2 += h1;
+    return DocumentHash { h1, h2 };
+}
+
+DocumentHash
+murmur ( const void* data, std::size_t length, std::uint64_t tag )
+{
+    auto const bytes = static_cast<const unsigned char*> ( data );
+    std::uint64_t h1 = tag;
+    std::uint64_t h2 = tag;
+    std::size_t const blocks = length / 16;
+
+    for ( std::size_t i = 0; i < blocks; ++i )
+        mixBlock ( h1, h2, bytes + i * 16 );
+
+    return mixTail ( h1, h2, bytes + blocks * 16, length );
+}
+
+DocumentHash
+murmur ( DocumentHash const& first, DocumentHash const& second,
+         std::uint64_t tag )
+{
+    unsigned char buffer[32];
+    std::uint64_t const words[4] =
+        { first.low, first.high, second.low, second.high };
+
+    for ( int i = 0; i < 32; ++i )
+        buffer[i] = static_cast<unsigned char> ( words[i / 8] >> ( 8 * ( i % 8 ) ) );
+
+    return murmur ( buffer, sizeof ( buffer ), tag );
+}
+
+enum Tag : std::uint64_t
+{
+    tagNull = 1,
+    tagBoolean,
+    tagInteger,
+    tagReal,
+    tagString,
+    tagArray,
+    tagObject,
+    tagMember
+};
+
+} // namespace
+
+DocumentHasher::DocumentHasher ( ValueType type )
+    : type_ (type)
+    , count_ (0)
+    , state_ {0, 0}
+{
+}
+
+void
+DocumentHasher::addElement ( DocumentHash const& element )
+{
+    // Chain the elements so that their order matters.
+    state_ = murmur ( state_, element, tagArray );
+    ++count_;
+}
+
+void
+DocumentHasher::addMember ( std::string const& name, DocumentHash const& value )
+{
+    // Sum the members so that their order does not.
+    DocumentHash const member = murmur (
+        murmur ( name.data (), name.size (), tagMember ), value, tagMember );
+    state_.low += member.low;
+    state_.high += member.high;
+    ++count_;
+}
+
+DocumentHash
+DocumentHasher::finish () const
+{
+    std::uint64_t const tag = ( type_ == objectValue ) ? tagObject : tagArray;
+    return murmur ( state_, DocumentHash { count_, tag }, tag );
+}
+
+DocumentHash
+DocumentHasher::scalar ( Value const& value )
+{
+    switch ( value.type () )
+    {
+    case booleanValue:
+    {
+        unsigned char const b = value.asBool () ? 1 : 0;
+        return murmur ( &b, 1, tagBoolean );
+    }
+
+    // Signed and unsigned integers of equal value hash alike.
+    case intValue:
+    case uintValue:
+    {
+        std::int64_t const i = value.isInt () ?
+            std::int64_t ( value.asInt () ) : std::int64_t ( value.asUInt () );
+        return murmur ( DocumentHash { std::uint64_t ( i ), 0 },
+            DocumentHash { 0, 0 }, tagInteger );
+    }
+
+    case realValue:
+    {
+        double d = value.asDouble ();
+
+        if ( d == 0 )
+            d = 0; // -0.0 and 0.0 hash alike
+
+        std::uint64_t bits;
+        std::memcpy ( &bits, &d, sizeof ( bits ) );
+        return murmur ( DocumentHash { bits, 0 }, DocumentHash { 0, 0 },
+            tagReal );
+    }
+
+    case stringValue:
+    {
+        std::string const s = value.asString ();
+        StringHasher hasher;
+        hasher.append ( s.data (), s.size () );
+        return hasher.finish ();
+    }
+
+    default:
+        return murmur ( nullptr, 0, tagNull );
+    }
+}
+
+DocumentHash
+DocumentHasher::hash ( Value const& value )
+{
+    if ( value.isArray () )
+    {
+        DocumentHasher hasher ( arrayValue );
+
+        for ( Value::UInt i = 0; i < value.size (); ++i )
+            hasher.addElement ( hash ( value[i] ) );
+
+        return hasher.finish ();
+    }
+
+    if ( value.isObject () )
+    {
+        DocumentHasher hasher ( objectValue );
+
+        for ( auto it = value.begin (); it != value.end (); ++it )
+            hasher.addMember ( it.memberName (), hash ( *it ) );
+
+        return hasher.finish ();
+    }
+
+    return scalar ( value );
+}
+
+//------------------------------------------------------------------------------
+
+StringHasher::StringHasher ()
+    : h1_ (tagString)
+    , h2_ (tagString)
+    , length_ (0)
+{
+}
+
+void
+StringHasher::append ( const char* data, std::size_t size )
+{
+    auto bytes = reinterpret_cast<const unsigned char*> ( data );
+    std::size_t used = length_ & 15;
+    length_ += size;
+
+    // Complete a block left partial by the last piece.
+    if ( used != 0 )
+    {
+        std::size_t const n = std::min<std::size_t> ( 16 - used, size );
+        std::memcpy ( block_ + used, bytes, n );
+        bytes += n;
+        size -= n;
+
+        if ( used + n < 16 )
+            return;
+
+        mixBlock ( h1_, h2_, block_ );
+    }
+
+    for ( ; size >= 16; bytes += 16, size -= 16 )
+        mixBlock ( h1_, h2_, bytes );
+
+    std::memcpy ( block_, bytes, size );
+}
+
+DocumentHash
+StringHasher::finish () const
+{
+    return mixTail ( h1_, h2_, block_, length_ );
+}
+
+} // namespace Json
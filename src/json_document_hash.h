@@ -0,0 +1,117 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_JSON_JSON_DOCUMENT_HASH_H_INCLUDED
+#define RIPPLE_JSON_JSON_DOCUMENT_HASH_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Json
+{
+
+/** \brief A 128-bit hash of a JSON value.
+
+    The hash is taken over the decoded values, so it ignores whitespace,
+    comments and string escaping, and object members are combined in an
+    order-insensitive way. Two documents that differ only in formatting or
+    member order therefore hash equal.
+*/
+struct DocumentHash
+{
+    std::uint64_t low;
+    std::uint64_t high;
+};
+
+inline
+bool
+operator== ( DocumentHash const& lhs, DocumentHash const& rhs )
+{
+    return lhs.low == rhs.low  &&  lhs.high == rhs.high;
+}
+
+inline
+bool
+operator!= ( DocumentHash const& lhs, DocumentHash const& rhs )
+{
+    return !( lhs == rhs );
+}
+
+/** \brief Computes a DocumentHash bottom up.
+
+    A DocumentHasher accumulates the hash of one array or object as its
+    children are added, which lets Reader hash a document incrementally as
+    each container closes. Array elements are combined in order; object
+    members are summed, so their order does not matter.
+*/
+class DocumentHasher
+{
+public:
+    /// \brief Start hashing a container of the given type.
+    explicit DocumentHasher ( ValueType type );
+
+    void addElement ( DocumentHash const& element );
+
+    void addMember ( std::string const& name, DocumentHash const& value );
+
+    /// \brief The hash of the container and everything added to it.
+    DocumentHash finish () const;
+
+    /// \brief The hash of a value that is neither an array nor an object.
+    static DocumentHash scalar ( Value const& value );
+
+    /// \brief The hash of a complete value, computed recursively.
+    static DocumentHash hash ( Value const& value );
+
+private:
+    ValueType type_;
+    std::uint64_t count_;
+    DocumentHash state_;
+};
+
+/** \brief Computes the hash of a string value from consecutive pieces.
+
+    The result equals DocumentHasher::scalar() of a Value holding the whole
+    string, however it is divided, so strings that Reader streams to a
+    handler in chunks hash as if they had been stored.
+*/
+class StringHasher
+{
+public:
+    StringHasher ();
+
+    /// \brief Add the next \a size bytes of the string.
+    void append ( const char* data, std::size_t size );
+
+    /// \brief The hash of the bytes added so far.
+    DocumentHash finish () const;
+
+private:
+    std::uint64_t h1_;
+    std::uint64_t h2_;
+    std::uint64_t length_;
+    unsigned char block_[16];
+};
+
+} // namespace Json
+
+#endif
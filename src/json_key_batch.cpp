@@ -0,0 +1,440 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_key_batch.h>
+#include <json_lines_reader.h>
+#include <json_reader.h>
+#include <json_struct_writer.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+
+namespace Json
+{
+
+namespace {
+
+// The key file as the validator-keys tool writes it.
+struct KeyFile
+{
+    std::string keyType;
+    std::string publicKey;
+    bool revoked = false;
+    std::string secretKey;
+    unsigned tokenSequence = 0;
+};
+
+// A validator in the lines layout.
+struct Record
+{
+    KeyFile keyFile;
+    std::string token;
+};
+
+} // namespace
+
+template <>
+struct Binding<KeyFile>
+{
+    static constexpr auto fields ()
+    {
+        return std::make_tuple (
+            field ( "key_type", &KeyFile::keyType ),
+            field ( "public_key", &KeyFile::publicKey ),
+            field ( "revoked", &KeyFile::revoked ),
+            field ( "secret_key", &KeyFile::secretKey ),
+            field ( "token_sequence", &KeyFile::tokenSequence ) );
+    }
+};
+
+template <>
+struct Binding<Record>
+{
+    static constexpr auto fields ()
+    {
+        return std::make_tuple (
+            field ( "key_file", &Record::keyFile ),
+            field ( "token", &Record::token ) );
+    }
+};
+
+namespace {
+
+KeyFile
+keyFile ( ValidatorKeys const& keys )
+{
+    KeyFile file;
+    file.keyType = keys.keyType == KeyType::ed25519 ? "ed25519" : "secp256k1";
+    file.publicKey = keys.publicKeyText ();
+    file.secretKey = keys.secretKeyText ();
+    file.tokenSequence = keys.tokenSequence;
+    return file;
+}
+
+std::string
+keyFilePath ( std::string const& directory, std::size_t i )
+{
+    return directory + "/validator-keys-" + std::to_string ( i + 1 ) + ".json";
+}
+
+std::string
+tokenPath ( std::string const& directory, std::size_t i )
+{
+    return directory + "/validator-token-" + std::to_string ( i + 1 ) + ".txt";
+}
+
+bool
+writeFile ( std::string const& path, std::string const& text )
+{
+    std::FILE* file = std::fopen ( path.c_str (), "wb" );
+
+    if ( !file )
+        return false;
+
+    bool const ok =
+        std::fwrite ( text.data (), 1, text.size (), file ) == text.size ();
+    return std::fclose ( file ) == 0  &&  ok;
+}
+
+bool
+readFile ( std::string const& path, std::string& buffer )
+{
+    std::FILE* file = std::fopen ( path.c_str (), "rb" );
+
+    if ( !file )
+        return false;
+
+    buffer.clear ();
+    char chunk[64 * 1024];
+    std::size_t count;
+
+    while ( ( count = std::fread ( chunk, 1, sizeof ( chunk ), file ) ) > 0 )
+        buffer.append ( chunk, count );
+
+    bool const ok = !std::ferror ( file );
+    std::fclose ( file );
+    return ok;
+}
+
+} // namespace
+
+KeyBatch::KeyBatch ( KeyType type, unsigned threads )
+    : type_ ( type )
+    , threads_ ( threads )
+{
+    if ( threads_ == 0 )
+        threads_ = std::max ( std::thread::hardware_concurrency (), 1u );
+}
+
+template <class Work>
+void
+KeyBatch::forEachShare ( Work const& work )
+{
+    // Validators cost the same to generate and check, so each thread
+    // takes one contiguous share.
+    unsigned const threads = static_cast<unsigned> ( std::min<std::size_t> (
+        threads_, std::max<std::size_t> ( validators_.size (), 1 ) ) );
+    std::size_t const perThread =
+        ( validators_.size () + threads - 1 ) / threads;
+
+    auto share = [&] ( unsigned t )
+    {
+        std::size_t const begin =
+            std::min ( validators_.size (), t * perThread );
+        work ( t, begin, std::min ( validators_.size (), begin + perThread ) );
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve ( threads - 1 );
+
+    for ( unsigned t = 1; t < threads; ++t )
+        workers.emplace_back ( share, t );
+
+    share ( 0 );
+
+    for ( auto& worker : workers )
+        worker.join ();
+}
+
+bool
+KeyBatch::fail ( std::vector<std::string> const& errors )
+{
+    // Shares are in order, so the first failing share holds the first
+    // failing validator.
+    for ( auto const& error : errors )
+    {
+        if ( !error.empty () )
+        {
+            errors_ = error;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool
+KeyBatch::generate ( std::size_t count )
+{
+    errors_.clear ();
+    validators_.assign ( count, Validator () );
+    std::vector<std::string> errors ( threads_ );
+
+    forEachShare ( [&] ( unsigned t, std::size_t begin, std::size_t end )
+    {
+        try
+        {
+            std::vector<ValidatorKeys> masters ( end - begin );
+            std::vector<ValidatorKeys> ephemeral ( end - begin );
+            KeyGenerator ( type_ ).generate ( masters );
+            KeyGenerator ( KeyType::secp256k1 ).generate ( ephemeral );
+
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                Validator& validator = validators_[i];
+                validator.keys = masters[i - begin];
+                validator.keys.tokenSequence = 1;
+
+                if ( !createToken ( validator.keys, ephemeral[i - begin],
+                        validator.keys.tokenSequence, validator.token ) )
+                {
+                    errors[t] = "Unable to sign the token of validator " +
+                        std::to_string ( i + 1 ) + ".\n";
+                    return;
+                }
+            }
+        }
+        catch ( std::exception const& e )
+        {
+            errors[t] = std::string ( e.what () ) + "\n";
+        }
+    } );
+
+    if ( fail ( errors ) )
+        return true;
+
+    validators_.clear ();
+    return false;
+}
+
+bool
+KeyBatch::write ( std::string const& path, Layout layout )
+{
+    errors_.clear ();
+    std::vector<std::string> errors ( threads_ );
+
+    if ( layout == Layout::lines )
+    {
+        // Each thread formats its share into one buffer, and the buffers
+        // are written in order, so the file is written in a few large
+        // writes however many validators it holds.
+        std::vector<std::string> buffers ( threads_ );
+
+        forEachShare ( [&] ( unsigned t, std::size_t begin, std::size_t end )
+        {
+            StructWriter writer;
+            Record record;
+
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                record.keyFile = keyFile ( validators_[i].keys );
+                record.token = validators_[i].token;
+                buffers[t] += writer.write ( record );
+                buffers[t] += '\n';
+            }
+        } );
+
+        std::FILE* file = std::fopen ( path.c_str (), "wb" );
+        bool ok = file != nullptr;
+
+        for ( auto const& buffer : buffers )
+            ok = ok  &&  std::fwrite ( buffer.data (), 1, buffer.size (), file )
+                == buffer.size ();
+
+        if ( !file  ||  std::fclose ( file ) != 0  ||  !ok )
+        {
+            errors_ = "Unable to write '" + path + "'.\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::create_directories ( path, ec );
+
+    if ( ec )
+    {
+        errors_ = "Unable to create '" + path + "': " + ec.message () + "\n";
+        return false;
+    }
+
+    forEachShare ( [&] ( unsigned t, std::size_t begin, std::size_t end )
+    {
+        StructWriter writer;
+        std::string text;
+
+        for ( std::size_t i = begin; i < end; ++i )
+        {
+            text = writer.write ( keyFile ( validators_[i].keys ) );
+            text += '\n';
+
+            if ( !writeFile ( keyFilePath ( path, i ), text ) )
+            {
+                errors[t] = "Unable to write '" + keyFilePath ( path, i ) + "'.\n";
+                return;
+            }
+
+            text = validators_[i].token;
+            text += '\n';
+
+            if ( !writeFile ( tokenPath ( path, i ), text ) )
+            {
+                errors[t] = "Unable to write '" + tokenPath ( path, i ) + "'.\n";
+                return;
+            }
+        }
+    } );
+
+    return fail ( errors );
+}
+
+bool
+KeyBatch::checkValidator ( std::size_t i, Value const& keyFile,
+                           std::string const& token, std::string& errors ) const
+{
+    std::string const name = "Validator " + std::to_string ( i + 1 );
+    ValidatorKeys keys;
+    ValidatorKeys const& expected = validators_[i].keys;
+
+    if ( !ValidatorKeys::fromJson ( keyFile, keys ) )
+    {
+        errors = name + ": the key file is invalid.\n";
+        return false;
+    }
+
+    if ( keys.keyType != expected.keyType
+        ||  keys.secretKey != expected.secretKey
+        ||  keys.tokenSequence != expected.tokenSequence )
+    {
+        errors = name + ": the key file holds other keys.\n";
+        return false;
+    }
+
+    std::string tokenErrors;
+
+    if ( !checkToken ( token, keys, keys.tokenSequence, tokenErrors ) )
+    {
+        errors = name + ": " + tokenErrors + "\n";
+        return false;
+    }
+
+    return true;
+}
+
+bool
+KeyBatch::verify ( std::string const& path, Layout layout )
+{
+    errors_.clear ();
+    std::vector<std::string> errors ( threads_ );
+
+    if ( layout == Layout::lines )
+    {
+        std::string document;
+
+        if ( !readFile ( path, document ) )
+        {
+            errors_ = "Unable to read '" + path + "'.\n";
+            return false;
+        }
+
+        LinesReader reader;
+        std::vector<Value> records;
+
+        if ( !reader.parse ( document, records, threads_ ) )
+        {
+            errors_ = reader.getFormatedErrorMessages ();
+            return false;
+        }
+
+        if ( records.size () != validators_.size () )
+        {
+            errors_ = "Expected " + std::to_string ( validators_.size () ) +
+                " validators but read " + std::to_string ( records.size () ) +
+                ".\n";
+            return false;
+        }
+
+        forEachShare ( [&] ( unsigned t, std::size_t begin, std::size_t end )
+        {
+            for ( std::size_t i = begin; i < end; ++i )
+            {
+                if ( !checkValidator ( i, records[i]["key_file"],
+                        records[i]["token"].asString (), errors[t] ) )
+                    return;
+            }
+        } );
+
+        return fail ( errors );
+    }
+
+    forEachShare ( [&] ( unsigned t, std::size_t begin, std::size_t end )
+    {
+        Reader reader;
+        std::string buffer;
+        std::string token;
+        Value keyFile;
+
+        for ( std::size_t i = begin; i < end; ++i )
+        {
+            if ( !readFile ( keyFilePath ( path, i ), buffer )
+                ||  !readFile ( tokenPath ( path, i ), token ) )
+            {
+                errors[t] = "Validator " + std::to_string ( i + 1 ) +
+                    ": unable to read its files.\n";
+                return;
+            }
+
+            if ( !reader.parse ( buffer, keyFile ) )
+            {
+                errors[t] = "In '" + keyFilePath ( path, i ) + "':\n" +
+                    reader.getFormatedErrorMessages ();
+                return;
+            }
+
+            if ( !token.empty ()  &&  token.back () == '\n' )
+                token.pop_back ();
+
+            if ( !checkValidator ( i, keyFile, token, errors[t] ) )
+                return;
+        }
+    } );
+
+    return fail ( errors );
+}
+
+std::string
+KeyBatch::getFormatedErrorMessages () const
+{
+    return errors_;
+}
+
+} // namespace Json
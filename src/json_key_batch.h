@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_KEY_BATCH_H_INCLUDED
+#define RIPPLE_JSON_JSON_KEY_BATCH_H_INCLUDED
+
+#include <json_validator_keys.h>
+#include <string>
+#include <vector>
+
+namespace Json
+{
+
+/** \brief Generate validator key files and tokens in bulk.
+
+    Test networks and staging need thousands of validators at a time. Each
+    validator is a master key pair, kept in a key file, and a token that
+    lets a secp256k1 ephemeral key pair validate for it. KeyBatch divides
+    the validators among threads, each generating, signing and formatting
+    its own contiguous share with its own KeyGenerators and buffers, so the
+    time falls with the number of cores. Written batches are read back
+    through Reader and every key file and token checked.
+*/
+class KeyBatch
+{
+public:
+    /// \brief How written validators are laid out.
+    enum class Layout
+    {
+        /** One JSON Lines file with a record per validator, whose
+            \c key_file is the key file and \c token the token. */
+        lines,
+
+        /** A directory holding validator-keys-<i>.json, the key file, and
+            validator-token-<i>.txt, the token, for validators 1 to N. */
+        files
+    };
+
+    /// \brief One validator.
+    struct Validator
+    {
+        ValidatorKeys keys;     ///< Master keys, with the token's sequence
+        std::string token;      ///< The token for the first ephemeral keys
+    };
+
+    /** \brief Create a batch of master key pairs of type \a type, using
+     *         \a threads threads. Zero means one thread per hardware thread.
+     */
+    explicit KeyBatch ( KeyType type, unsigned threads = 0 );
+
+    /** \brief Generate \a count validators, replacing any generated before.
+     * \return \c false if a token could not be signed.
+     */
+    bool generate ( std::size_t count );
+
+    /// \brief The validators generated, in order.
+    std::vector<Validator> const& validators () const
+    {
+        return validators_;
+    }
+
+    /** \brief Write the validators to \a path, a file or a directory
+     *         depending on \a layout. A directory is created if need be.
+     * \return \c true if every file was written.
+     */
+    bool write ( std::string const& path, Layout layout );
+
+    /** \brief Read back a batch written to \a path and check that it
+     *         holds exactly the validators generated.
+     *
+     * Each key file must hold the generated keys and each token must be
+     * valid for them, as checkToken() decides.
+     * \return \c true if every validator was read back intact.
+     */
+    bool verify ( std::string const& path, Layout layout );
+
+    /** \brief Returns a user friendly string describing the first
+     *         failure, or an empty string.
+     */
+    std::string getFormatedErrorMessages () const;
+
+private:
+    template <class Work>
+    void forEachShare ( Work const& work );
+
+    bool checkValidator ( std::size_t i, Value const& keyFile,
+                          std::string const& token, std::string& errors ) const;
+
+    bool fail ( std::vector<std::string> const& errors );
+
+    KeyType type_;
+    unsigned threads_;
+    std::vector<Validator> validators_;
+    std::string errors_;
+};
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,242 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_lines_reader.h>
+#include <json_reader.h>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <thread>
+
+namespace Json
+{
+
+std::vector<LinesReader::Line>
+LinesReader::split ( const char* beginDoc, const char* endDoc )
+{
+    std::vector<Line> lines;
+    std::size_t number = 0;
+
+    for ( const char* begin = beginDoc; begin != endDoc; )
+    {
+        auto const newline = static_cast<const char*> (
+            std::memchr ( begin, '\n', endDoc - begin ) );
+        const char* const end = newline ? newline : endDoc;
+        ++number;
+
+        if ( std::any_of ( begin, end, [] ( char c )
+                {
+                    return c != ' '  &&  c != '\t'  &&  c != '\r';
+                } ) )
+            lines.push_back ( Line { begin, end, number } );
+
+        begin = newline ? newline + 1 : endDoc;
+    }
+
+    return lines;
+}
+
+bool
+LinesReader::parse ( std::string const& document,
+                     std::vector<Value>& records, unsigned threads )
+{
+    return parse ( document.data (), document.data () + document.size (),
+        records, threads );
+}
+
+bool
+LinesReader::parse ( const char* beginDoc, const char* endDoc,
+                     std::vector<Value>& records, unsigned threads )
+{
+    errors_.clear ();
+    return parseLines ( split ( beginDoc, endDoc ), records, threads );
+}
+
+bool
+LinesReader::select ( const char* beginDoc, const char* endDoc,
+                      std::vector<std::string> const& needles,
+                      std::function<bool (Value const&)> const& predicate,
+                      std::vector<Value>& records, unsigned threads )
+{
+    errors_.clear ();
+    records.clear ();
+
+    auto const lines = split ( beginDoc, endDoc );
+    std::vector<char> candidate ( lines.size (), 0 );
+
+    // Count the bytes of the document's head, to find which byte of each
+    // needle is rarest in this document.
+    std::size_t counts[256] = {};
+    std::size_t const sampleSize =
+        std::min<std::size_t> ( endDoc - beginDoc, 64 * 1024 );
+
+    for ( std::size_t i = 0; i < sampleSize; ++i )
+        ++counts[static_cast<unsigned char> ( beginDoc[i] )];
+
+    // Search the whole document for each needle with memchr, which the C
+    // library vectorizes, on the needle's rarest byte rather than its first,
+    // which is often a quote present many times on every line. Once a line
+    // is known to be a candidate, the search jumps to its end.
+    for ( auto const& needle : needles )
+    {
+        if ( needle.empty () )
+        {
+            std::fill ( candidate.begin (), candidate.end (), 1 );
+            break;
+        }
+
+        std::size_t const size = needle.size ();
+        std::size_t anchor = size - 1;
+
+        for ( std::size_t i = size - 1; i-- > 0; )
+        {
+            if ( counts[static_cast<unsigned char> ( needle[i] )] <
+                    counts[static_cast<unsigned char> ( needle[anchor] )] )
+                anchor = i;
+        }
+
+        // p is where the next match may start.
+        const char* p = beginDoc;
+
+        while ( std::size_t ( endDoc - p ) >= size )
+        {
+            auto const found = static_cast<const char*> ( std::memchr (
+                p + anchor, needle[anchor], ( endDoc - p ) - size + 1 ) );
+
+            if ( !found )
+                break;
+
+            p = found - anchor;
+
+            if ( std::memcmp ( p, needle.data (), size ) != 0 )
+            {
+                ++p;
+                continue;
+            }
+
+            // Find the line holding the match. A match spanning a line
+            // break belongs to no record and is skipped.
+            auto const line = std::upper_bound ( lines.begin (), lines.end (), p,
+                [] ( const char* q, Line const& l )
+                {
+                    return q < l.begin;
+                } );
+
+            if ( line != lines.begin ()  &&  p + size <= std::prev ( line )->end )
+            {
+                candidate[std::prev ( line ) - lines.begin ()] = 1;
+                p = std::prev ( line )->end;
+            }
+            else
+            {
+                ++p;
+            }
+        }
+    }
+
+    std::vector<Line> candidates;
+
+    for ( std::size_t i = 0; i < lines.size (); ++i )
+    {
+        if ( candidate[i] )
+            candidates.push_back ( lines[i] );
+    }
+
+    std::vector<Value> parsed;
+
+    if ( !parseLines ( candidates, parsed, threads ) )
+        return false;
+
+    for ( auto& value : parsed )
+    {
+        if ( predicate ( value ) )
+            records.push_back ( std::move ( value ) );
+    }
+
+    return true;
+}
+
+bool
+LinesReader::parseLines ( std::vector<Line> const& lines,
+                          std::vector<Value>& records, unsigned threads )
+{
+    records.clear ();
+    records.resize ( lines.size () );
+
+    if ( threads < 1 )
+        threads = 1;
+
+    if ( threads > lines.size () )
+        threads = std::max<std::size_t> ( lines.size (), 1 );
+
+    // Each thread reports the first line it could not parse.
+    std::size_t const none = lines.size ();
+    std::vector<std::size_t> failed ( threads, none );
+    std::vector<std::string> messages ( threads );
+    std::size_t const perThread = ( lines.size () + threads - 1 ) / threads;
+
+    auto work = [&] ( unsigned t )
+    {
+        Reader reader;
+        std::size_t const last =
+            std::min ( lines.size (), ( t + 1 ) * perThread );
+
+        for ( std::size_t i = t * perThread; i < last; ++i )
+        {
+            if ( !reader.parseValue ( lines[i].begin, lines[i].end, records[i] ) )
+            {
+                failed[t] = i;
+                messages[t] = reader.getFormatedErrorMessages ();
+                return;
+            }
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve ( threads - 1 );
+
+    for ( unsigned t = 1; t < threads; ++t )
+        workers.emplace_back ( work, t );
+
+    work ( 0 );
+
+    for ( auto& worker : workers )
+        worker.join ();
+
+    for ( unsigned t = 0; t < threads; ++t )
+    {
+        if ( failed[t] != none )
+        {
+            errors_ = "In the record on line " +
+                std::to_string ( lines[failed[t]].number ) + ":\n" + messages[t];
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string
+LinesReader::getFormatedErrorMessages () const
+{
+    return errors_;
+}
+
+} // namespace Json
@@ -0,0 +1,99 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_JSON_JSON_LINES_READER_H_INCLUDED
+#define RIPPLE_JSON_JSON_LINES_READER_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace Json
+{
+
+/** \brief Read a <a HREF="https://jsonlines.org">JSON Lines</a> document.
+
+    Each non-blank line holds one JSON value. Large batches, such as
+    thousands of generated key files written as one file, can be read on
+    several threads: the lines are split into contiguous runs and each run
+    is parsed by its own Reader, so the work scales with the cores given.
+*/
+class LinesReader
+{
+public:
+    /** \brief Read every record of a JSON Lines document.
+     * \param records [out] The values of the non-blank lines, in order.
+     * \param threads Number of threads to parse with.
+     * \return \c true if every record was successfully parsed, \c false if
+     *         an error occurred.
+     */
+    bool parse ( const char* beginDoc, const char* endDoc,
+                 std::vector<Value>& records, unsigned threads = 1 );
+
+    bool parse ( std::string const& document,
+                 std::vector<Value>& records, unsigned threads = 1 );
+
+    /** \brief Read only the records that match a query.
+     *
+     * Selective queries over large files would otherwise parse every
+     * record only to discard most of them. The raw text of the document is
+     * first searched for \a needles, for example the quoted account
+     * address being looked for; only lines containing at least one needle
+     * are parsed, and \a predicate then confirms each parsed candidate.
+     * The needles must therefore occur verbatim in the text of every
+     * record the predicate accepts. A needle spanning a line break
+     * matches no record, and an empty needle matches every record.
+     * \param records [out] The matching records, in document order.
+     * \param threads Number of threads to parse candidates with. The
+     *        predicate is always called on the calling thread.
+     * \return \c true if every candidate was successfully parsed, \c false
+     *         if an error occurred.
+     */
+    bool select ( const char* beginDoc, const char* endDoc,
+                  std::vector<std::string> const& needles,
+                  std::function<bool (Value const&)> const& predicate,
+                  std::vector<Value>& records, unsigned threads = 1 );
+
+    /** \brief Returns a user friendly string that list the errors of the
+     *         first record that failed to parse, prefixed by its line.
+     */
+    std::string getFormatedErrorMessages () const;
+
+    /// \brief The non-blank lines of a document, in order.
+    struct Line
+    {
+        const char* begin;
+        const char* end;
+        std::size_t number;     ///< 1-based line number in the document
+    };
+
+    static std::vector<Line> split ( const char* beginDoc, const char* endDoc );
+
+private:
+    bool parseLines ( std::vector<Line> const& lines,
+                      std::vector<Value>& records, unsigned threads );
+
+    std::string errors_;
+};
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_member_index.h>
+#include <cstring>
+#include <random>
+
+namespace Json
+{
+
+namespace {
+
+// A fresh 128-bit key per index, drawn from a generator seeded once per
+// thread from the system's entropy source.
+void
+randomKey ( std::uint64_t ( &key )[2] )
+{
+    thread_local std::mt19937_64 engine ( [] ()
+    {
+        std::random_device device;
+        std::seed_seq seed { device (), device (), device (), device () };
+        return std::mt19937_64 ( seed );
+    } () );
+
+    key[0] = engine ();
+    key[1] = engine ();
+}
+
+std::uint64_t
+rotate ( std::uint64_t x, int bits )
+{
+    return ( x << bits ) | ( x >> ( 64 - bits ) );
+}
+
+void
+sipRound ( std::uint64_t ( &v )[4] )
+{
+    v[0] += v[1]; v[1] = rotate ( v[1], 13 ); v[1] ^= v[0];
+    v[0] = rotate ( v[0], 32 );
+    v[2] += v[3]; v[3] = rotate ( v[3], 16 ); v[3] ^= v[2];
+    v[0] += v[3]; v[3] = rotate ( v[3], 21 ); v[3] ^= v[0];
+    v[2] += v[1]; v[1] = rotate ( v[1], 17 ); v[1] ^= v[2];
+    v[2] = rotate ( v[2], 32 );
+}
+
+} // namespace
+
+MemberIndex::MemberIndex ()
+    : mask_ (0)
+    , size_ (0)
+{
+    randomKey ( key_ );
+}
+
+MemberIndex::MemberIndex ( Value const& object )
+    : MemberIndex ()
+{
+    if ( !object.isObject () )
+        return;
+
+    for ( auto it = object.begin (); it != object.end (); ++it )
+    {
+        const char* name = it.memberName ();
+        insert ( name, std::strlen ( name ), *it );
+    }
+}
+
+void
+MemberIndex::insert ( const char* name, std::size_t length,
+                      Value const& value )
+{
+    // Keep the table at most half full so probe sequences stay short.
+    if ( 2 * ( size_ + 1 ) > slots_.size () )
+    {
+        std::vector<Slot> old;
+        old.swap ( slots_ );
+        slots_.assign ( old.empty () ? 16 : 2 * old.size (),
+            Slot { 0, 0, 0, nullptr } );
+        mask_ = slots_.size () - 1;
+
+        for ( auto const& slot : old )
+            if ( slot.value )
+                place ( slot );
+    }
+
+    place ( Slot { hash ( name, length ), names_.size (), length, &value } );
+    names_.append ( name, length );
+    ++size_;
+}
+
+void
+MemberIndex::place ( Slot const& slot )
+{
+    std::size_t i = slot.hash & mask_;
+
+    while ( slots_[i].value )
+        i = ( i + 1 ) & mask_;
+
+    slots_[i] = slot;
+}
+
+Value const*
+MemberIndex::find ( const char* name, std::size_t length ) const
+{
+    if ( slots_.empty () )
+        return nullptr;
+
+    std::uint64_t const h = hash ( name, length );
+
+    for ( std::size_t i = h & mask_; slots_[i].value; i = ( i + 1 ) & mask_ )
+    {
+        Slot const& slot = slots_[i];
+
+        if ( slot.hash == h  &&  slot.length == length  &&
+                names_.compare ( slot.name, length, name, length ) == 0 )
+            return slot.value;
+    }
+
+    return nullptr;
+}
+
+std::uint64_t
+MemberIndex::hash ( const char* name, std::size_t length ) const
+{
+    // SipHash-2-4 of the name under this index's key.
+    std::uint64_t v[4] =
+    {
+        key_[0] ^ 0x736f6d6570736575ull,
+        key_[1] ^ 0x646f72616e646f6dull,
+        key_[0] ^ 0x6c7967656e657261ull,
+        key_[1] ^ 0x7465646279746573ull
+    };
+
+    auto const compress = [&v] ( std::uint64_t m )
+    {
+        v[3] ^= m;
+        sipRound ( v );
+        sipRound ( v );
+        v[0] ^= m;
+    };
+
+    auto const byte = [name] ( std::size_t i )
+    {
+        return std::uint64_t ( static_cast<unsigned char> ( name[i] ) );
+    };
+
+    std::size_t i = 0;
+
+    for ( ; i + 8 <= length; i += 8 )
+    {
+        std::uint64_t m = 0;
+
+        for ( int b = 0; b < 8; ++b )
+            m |= byte ( i + b ) << ( 8 * b );
+
+        compress ( m );
+    }
+
+    std::uint64_t m = std::uint64_t ( length ) << 56;
+
+    for ( int b = 0; i + b < length; ++b )
+        m |= byte ( i + b ) << ( 8 * b );
+
+    compress ( m );
+
+    v[2] ^= 0xff;
+
+    for ( int r = 0; r < 4; ++r )
+        sipRound ( v );
+
+    return v[0] ^ v[1] ^ v[2] ^ v[3];
+}
+
+} // namespace Json
@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_MEMBER_INDEX_H_INCLUDED
+#define RIPPLE_JSON_JSON_MEMBER_INDEX_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Json
+{
+
+/** \brief Constant time member lookup for very wide objects.
+
+    Looking up a member of a Value object walks a tree with a string
+    compare per level, which adds up for objects with many thousands of
+    members that are queried repeatedly, such as account maps or UNL
+    lookups keyed by public key. A MemberIndex hashes every member name
+    once and answers later lookups from an open addressing table.
+
+    Reader can build the index of wide objects while parsing them, see
+    Reader::indexMembers(). Member names usually come from outside, so
+    they are hashed with SipHash under a random key chosen for each index;
+    names picked to collide under one index do not collide under another.
+
+    The index keeps its own copy of the names but refers to the values
+    held by the object, so the object must outlive the index and must not
+    be modified while the index is in use.
+*/
+class MemberIndex
+{
+public:
+    /// \brief An empty index, to be filled by insert().
+    MemberIndex ();
+
+    /** \brief Index the members of \a object.
+     * Values other than objects produce an empty index.
+     */
+    explicit MemberIndex ( Value const& object );
+
+    /** \brief Add a member to the index.
+     * The name must not already be indexed.
+     */
+    void insert ( const char* name, std::size_t length, Value const& value );
+
+    /** \brief Find a member by name.
+     * \return The member's value, or \c nullptr if there is no such member.
+     */
+    Value const* find ( const char* name, std::size_t length ) const;
+
+    Value const* find ( std::string const& name ) const
+    {
+        return find ( name.data (), name.size () );
+    }
+
+    /// \brief Number of members indexed.
+    std::size_t size () const
+    {
+        return size_;
+    }
+
+private:
+    struct Slot
+    {
+        std::uint64_t hash;
+        std::size_t name;
+        std::size_t length;
+        Value const* value;
+    };
+
+    std::uint64_t hash ( const char* name, std::size_t length ) const;
+    void place ( Slot const& slot );
+
+    std::uint64_t key_[2];
+    std::vector<Slot> slots_;
+    std::string names_;
+    std::size_t mask_;
+    std::size_t size_;
+};
+
+} // namespace Json
+
+#endif
@@ -20,9 +20,33 @@
 #include <BeastConfig.h>
 #include <ripple/basics/contract.h>
 #include <json_reader.h>
+#include <json_base64.h>
+#include <json_document_hash.h>
+#include <json_structural_index.h>
 #include <algorithm>
+#include <cstring>
 #include <string>
-#include <cctype>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Static tracepoints for the parse phases. Building with JSON_READER_USDT
+// defined to 1 emits USDT probes under the "json_reader" provider, which
+// bpftrace and perf can attach to in production; otherwise they compile
+// away entirely. Every container, error and recovery probe fires within a
+// parse__begin and parse__end pair on the same thread.
+#if JSON_READER_USDT
+#include <sys/sdt.h>
+#define JSON_READER_PROBE2(name, a1, a2) \
+    DTRACE_PROBE2 (json_reader, name, a1, a2)
+#define JSON_READER_PROBE3(name, a1, a2, a3) \
+    DTRACE_PROBE3 (json_reader, name, a1, a2, a3)
+#else
+#define JSON_READER_PROBE2(name, a1, a2) \
+    ((void)sizeof ((a1), (a2)))
+#define JSON_READER_PROBE3(name, a1, a2, a3) \
+    ((void)sizeof ((a1), (a2), (a3)))
+#endif
 
 namespace Json
 {
@@ -71,8 +95,66 @@ codePointToUTF8 (unsigned int cp)
 // Class Reader
 // //////////////////////////////////////////////////////////////////
 
+constexpr std::size_t Reader::stream_chunk_size;
+
 Reader::Reader ()
+    : arrayState_ (arrayNone)
+    , stringPool_ (nullptr)
+    , stringThreshold_ (0)
+    , streamedString_ (false)
+    , hashing_ (false)
+    , indexThreshold_ (0)
+{
+}
+
+
+void
+Reader::enableDocumentHash ( bool enable )
+{
+    hashing_ = enable;
+    hashes_.clear ();
+}
+
+
+DocumentHash
+Reader::documentHash () const
+{
+    if ( !hashing_  ||  hashes_.size () != 1 )
+        return DocumentHash { 0, 0 };
+
+    return hashes_.back ();
+}
+
+
+void
+Reader::indexMembers ( std::size_t threshold )
+{
+    indexThreshold_ = threshold;
+    memberIndexes_.clear ();
+}
+
+
+MemberIndex const*
+Reader::memberIndex ( Value const& object ) const
+{
+    auto const found = memberIndexes_.find ( &object );
+    return found == memberIndexes_.end () ? nullptr : &found->second;
+}
+
+
+void
+Reader::setStringPool ( StringPool* pool )
 {
+    stringPool_ = pool;
+}
+
+
+void
+Reader::streamLargeStrings ( std::size_t threshold,
+                             StringChunkHandler handler )
+{
+    stringThreshold_ = threshold;
+    stringHandler_ = std::move ( handler );
 }
 
 
@@ -87,6 +169,41 @@ Reader::parse ( std::string const& document,
 }
 
 
+bool
+Reader::parseBase64 ( std::string const& encoded,
+                      Value& root )
+{
+    document_.clear ();
+
+    if ( !base64Decode ( encoded.data (), encoded.data () + encoded.size (),
+            document_ ) )
+    {
+        // Report the error against the encoded text.
+        abandonArray ();
+        document_ = encoded;
+        begin_ = document_.c_str ();
+        end_ = begin_ + document_.length ();
+        current_ = end_;
+        errors_.clear ();
+        hashes_.clear ();
+        memberIndexes_.clear ();
+
+        Token token;
+        token.type_ = tokenError;
+        token.start_ = begin_;
+        token.end_ = end_;
+        probeParseBegin ( begin_, end_ );
+        addError ( "The document is not valid base64.", token );
+        probeParseEnd ( begin_, end_, false );
+        return false;
+    }
+
+    const char* begin = document_.c_str ();
+    const char* end = begin + document_.length ();
+    return parse ( begin, end, root );
+}
+
+
 bool
 Reader::parse ( std::istream& sin,
                 Value& root)
@@ -112,14 +229,19 @@ Reader::parse ( const char* beginDoc, const char* endDoc,
     current_ = begin_;
     lastValueEnd_ = 0;
     lastValue_ = 0;
+    abandonArray ();
     errors_.clear ();
+    hashes_.clear ();
+    memberIndexes_.clear ();
 
     while ( !nodes_.empty () )
         nodes_.pop ();
 
     nodes_.push ( &root );
 
-    bool successful = readValue ();
+    probeParseBegin ( beginDoc, endDoc );
+
+    bool successful = readValue ( 0 );
     Token token;
     skipCommentTokens ( token );
 
@@ -131,27 +253,414 @@ Reader::parse ( const char* beginDoc, const char* endDoc,
         token.end_ = endDoc;
         addError ( "A valid JSON document must be either an array or an object value.",
                    token );
+        successful = false;
+    }
+
+    // A failed parse has no document hash or indexes, even if a value
+    // was read.
+    if ( !successful )
+    {
+        hashes_.clear ();
+        memberIndexes_.clear ();
+    }
+
+    probeParseEnd ( beginDoc, endDoc, successful );
+    return successful;
+}
+
+bool
+Reader::parse ( const char* beginDoc, const char* endDoc,
+                Value& root, unsigned threads )
+{
+    std::vector<Value> elements;
+
+    if ( !readElementsConcurrently ( beginDoc, endDoc, elements, threads ) )
+        return parse ( beginDoc, endDoc, root );
+
+    root = Value ( arrayValue );
+
+    for ( std::size_t i = 0; i < elements.size (); ++i )
+        root[ Value::UInt ( i ) ] = std::move ( elements[i] );
+
+    return true;
+}
+
+bool
+Reader::parse ( const char* beginDoc, const char* endDoc,
+                std::vector<Value>& elements, unsigned threads )
+{
+    elements.clear ();
+
+    if ( readElementsConcurrently ( beginDoc, endDoc, elements, threads ) )
+        return true;
+
+    elements.clear ();
+
+    if ( !beginArray ( beginDoc, endDoc ) )
         return false;
+
+    Value element;
+
+    while ( nextElement ( element ) )
+        elements.push_back ( std::move ( element ) );
+
+    return good ();
+}
+
+bool
+Reader::readElementsConcurrently ( const char* beginDoc, const char* endDoc,
+                                   std::vector<Value>& elements,
+                                   unsigned threads )
+{
+    using Span = std::pair<Location, Location>;
+
+    // The handler is not expected to be called from several threads, and
+    // indexes would refer to the elements before they are moved.
+    if ( threads < 2  ||  stringHandler_  ||  indexThreshold_ )
+        return false;
+
+    StructuralIndex const index ( beginDoc, endDoc, threads );
+
+    Location first = beginDoc;
+
+    while ( first != endDoc  &&  ( *first == ' '  ||  *first == '\t'  ||
+            *first == '\r'  ||  *first == '\n' ) )
+        ++first;
+
+    if ( index.size () == 0  ||  beginDoc + index[0] != first  ||
+            *first != '[' )
+        return false;
+
+    // Split the array at the commas directly inside it.
+    std::vector<Span> spans;
+    Location elementStart = first + 1;
+    int depth = 0;
+    bool closed = false;
+
+    for ( auto const offset : index )
+    {
+        Location const p = beginDoc + offset;
+
+        switch ( *p )
+        {
+        case '{':
+        case '[':
+            ++depth;
+            break;
+
+        case '}':
+        case ']':
+            if ( --depth == 0 )
+            {
+                spans.emplace_back ( elementStart, p );
+                closed = true;
+            }
+            break;
+
+        case ',':
+            if ( depth == 1 )
+            {
+                spans.emplace_back ( elementStart, p );
+                elementStart = p + 1;
+            }
+            break;
+
+        case ':':
+            break;
+
+        default: // '/', a comment
+            return false;
+        }
+
+        if ( closed )
+            break;
+    }
+
+    if ( !closed  ||  spans.size () < threads )
+        return false;
+
+    // The elements of other threads are traced as separate spans.
+    probeParseBegin ( beginDoc, endDoc );
+
+    // Each thread builds a contiguous run of elements with its own Reader.
+    elements.resize ( spans.size () );
+    std::vector<DocumentHash> elementHashes ( hashing_ ? spans.size () : 0 );
+    std::vector<char> succeeded ( threads, 0 );
+    std::size_t const perThread = ( spans.size () + threads - 1 ) / threads;
+
+    auto work = [&] ( unsigned t )
+    {
+        Reader reader;
+        reader.enableDocumentHash ( hashing_ );
+        std::size_t const first = std::min ( spans.size (), t * perThread );
+        std::size_t const last =
+            std::min ( spans.size (), ( t + 1 ) * perThread );
+
+        if ( t != 0  &&  first != last )
+            probeParseBegin ( spans[first].first, spans[last - 1].second );
+
+        succeeded[t] = 1;
+
+        for ( std::size_t i = first; i < last  &&  succeeded[t]; ++i )
+        {
+            if ( !reader.readElement ( spans[i].first,
+                    spans[i].second, elements[i], 1 ) )
+                succeeded[t] = 0;
+            else if ( hashing_ )
+                elementHashes[i] = reader.documentHash ();
+        }
+
+        if ( t != 0  &&  first != last )
+            probeParseEnd ( spans[first].first, spans[last - 1].second,
+                succeeded[t] != 0 );
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve ( threads - 1 );
+
+    for ( unsigned t = 1; t < threads; ++t )
+        workers.emplace_back ( work, t );
+
+    work ( 0 );
+
+    for ( auto& worker : workers )
+        worker.join ();
+
+    // On failure the caller rereads the document sequentially, so errors
+    // carry their true location.
+    bool const successful = std::find ( succeeded.begin (),
+        succeeded.end (), 0 ) == succeeded.end ();
+    probeParseEnd ( beginDoc, endDoc, successful );
+
+    if ( !successful )
+        return false;
+
+    begin_ = beginDoc;
+    end_ = endDoc;
+    current_ = spans.back ().second + 1;
+    lastValueEnd_ = 0;
+    lastValue_ = 0;
+    abandonArray ();
+    errors_.clear ();
+    hashes_.clear ();
+
+    while ( !nodes_.empty () )
+        nodes_.pop ();
+
+    if ( hashing_ )
+    {
+        DocumentHasher hasher ( arrayValue );
+
+        for ( auto const& hash : elementHashes )
+            hasher.addElement ( hash );
+
+        hashes_.push_back ( hasher.finish () );
     }
 
+    return true;
+}
+
+bool
+Reader::parseValue ( const char* beginDoc, const char* endDoc, Value& value )
+{
+    lastValueEnd_ = 0;
+    lastValue_ = 0;
+    abandonArray ();
+
+    while ( !nodes_.empty () )
+        nodes_.pop ();
+
+    probeParseBegin ( beginDoc, endDoc );
+    bool const successful = readElement ( beginDoc, endDoc, value, 0 );
+    probeParseEnd ( beginDoc, endDoc, successful );
     return successful;
 }
 
 bool
-Reader::readValue ()
+Reader::readElement ( const char* beginDoc, const char* endDoc,
+                      Value& element, unsigned depth )
+{
+    begin_ = beginDoc;
+    end_ = endDoc;
+    current_ = begin_;
+    errors_.clear ();
+    hashes_.clear ();
+    memberIndexes_.clear ();
+
+    nodes_.push ( &element );
+    bool ok = readValue ( depth );
+    nodes_.pop ();
+
+    Token token;
+    skipCommentTokens ( token );
+    ok = ok  &&  token.type_ == tokenEndOfStream;
+
+    if ( !ok )
+    {
+        hashes_.clear ();
+        memberIndexes_.clear ();
+    }
+
+    return ok;
+}
+
+bool
+Reader::beginArray ( std::string const& document )
 {
+    document_ = document;
+    const char* begin = document_.c_str ();
+    const char* end = begin + document_.length ();
+    return beginArray ( begin, end );
+}
+
+bool
+Reader::beginArray ( const char* beginDoc, const char* endDoc )
+{
+    abandonArray ();
+    begin_ = beginDoc;
+    end_ = endDoc;
+    current_ = begin_;
+    lastValueEnd_ = 0;
+    lastValue_ = 0;
+    arrayState_ = arrayDone;
+    errors_.clear ();
+    memberIndexes_.clear ();
+
+    while ( !nodes_.empty () )
+        nodes_.pop ();
+
+    // The span lasts until nextElement() reaches the end of the array.
+    probeParseBegin ( begin_, end_ );
+
     Token token;
     skipCommentTokens ( token );
+
+    if ( token.type_ != tokenArrayBegin )
+    {
+        addError ( "The document root must be an array.", token );
+        probeParseEnd ( begin_, end_, false );
+        return false;
+    }
+
+    arrayState_ = arrayFirst;
+    return true;
+}
+
+bool
+Reader::nextElement ( Value& element )
+{
+    if ( arrayState_ == arrayFirst )
+    {
+        skipSpaces ();
+
+        if ( current_ != end_  &&  *current_ == ']' ) // empty array
+        {
+            Token endArray;
+            readToken ( endArray );
+            arrayState_ = arrayDone;
+            probeParseEnd ( begin_, end_, true );
+            return false;
+        }
+    }
+    else if ( arrayState_ == arrayMore )
+    {
+        Token token;
+        skipCommentTokens ( token );
+
+        if ( token.type_ == tokenArrayEnd )
+        {
+            arrayState_ = arrayDone;
+            probeParseEnd ( begin_, end_, true );
+            return false;
+        }
+
+        if ( token.type_ != tokenArraySeparator )
+        {
+            arrayState_ = arrayDone;
+            addError ( "Missing ',' or ']' in array declaration", token );
+            probeParseEnd ( begin_, end_, false );
+            return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    element = Value ();
+    hashes_.clear ();
+    memberIndexes_.clear ();
+    nodes_.push ( &element );
+    bool ok = readValue ( 1 );
+    nodes_.pop ();
+
+    arrayState_ = ok ? arrayMore : arrayDone;
+
+    if ( !ok )
+    {
+        hashes_.clear ();
+        memberIndexes_.clear ();
+        probeParseEnd ( begin_, end_, false );
+    }
+
+    return ok;
+}
+
+void
+Reader::abandonArray ()
+{
+    // An array left part way through still closes its span.
+    if ( arrayState_ == arrayFirst  ||  arrayState_ == arrayMore )
+        probeParseEnd ( begin_, end_, good () );
+
+    arrayState_ = arrayNone;
+}
+
+void
+Reader::probeParseBegin ( Location beginDoc, Location endDoc ) const
+{
+    JSON_READER_PROBE2 (parse__begin, beginDoc, endDoc - beginDoc);
+}
+
+void
+Reader::probeParseEnd ( Location beginDoc, Location endDoc,
+                        bool successful ) const
+{
+    JSON_READER_PROBE3 (parse__end, beginDoc, endDoc - beginDoc,
+        successful ? 1 : 0);
+}
+
+bool
+Reader::good () const
+{
+    return errors_.empty ();
+}
+
+bool
+Reader::readValue ( unsigned depth )
+{
+    Token token;
+    skipCommentTokens ( token );
+
+    if ( depth > nest_limit )
+        return addError ( "Syntax error: maximum nesting depth exceeded", token );
+
     bool successful = true;
 
     switch ( token.type_ )
     {
     case tokenObjectBegin:
-        successful = readObject ( token );
+        JSON_READER_PROBE2 (object__begin, token.start_ - begin_, depth);
+        successful = readObject ( token, depth );
+        JSON_READER_PROBE3 (object__end, current_ - begin_, depth,
+            successful ? 1 : 0);
         break;
 
     case tokenArrayBegin:
-        successful = readArray ( token );
+        JSON_READER_PROBE2 (array__begin, token.start_ - begin_, depth);
+        successful = readArray ( token, depth );
+        JSON_READER_PROBE3 (array__end, current_ - begin_, depth,
+            successful ? 1 : 0);
         break;
 
     case tokenInteger:
@@ -182,6 +691,12 @@ Reader::readValue ()
         return addError ( "Syntax error: value, object or array expected.", token );
     }
 
+    // Objects and arrays push their own hash as they close.
+    if ( hashing_  &&  successful  &&
+            token.type_ != tokenObjectBegin  &&  token.type_ != tokenArrayBegin )
+        hashes_.push_back ( token.type_ == tokenString  &&  streamedString_ ?
+            streamHash_.finish () : DocumentHasher::scalar ( currentValue () ) );
+
     return successful;
 }
 
@@ -353,7 +868,7 @@ Reader::readCStyleComment ()
     {
         Char c = getNextChar ();
 
-        if ( c == '*'  &&  *current_ == '/' )
+        if ( c == '*'  &&  current_ != end_  &&  *current_ == '/' )
             break;
     }
 
@@ -378,8 +893,6 @@ Reader::readCppStyleComment ()
 Reader::TokenType
 Reader::readNumber ()
 {
-    static char const extended_tokens[] = { '.', 'e', 'E', '+', '-' };
-
     TokenType type = tokenInteger;
 
     if ( current_ != end_ )
@@ -389,12 +902,12 @@ Reader::readNumber ()
 
         while ( current_ != end_ )
         {
-            if (!std::isdigit (*current_))
-            {
-                auto ret = std::find (std::begin (extended_tokens),
-                    std::end (extended_tokens), *current_);
+            Char c = *current_;
 
-                if (ret == std::end (extended_tokens))
+            if ( c < '0'  ||  c > '9' )
+            {
+                if ( c != '.'  &&  c != 'e'  &&  c != 'E'  &&
+                        c != '+'  &&  c != '-' )
                     break;
 
                 type = tokenDouble;
@@ -427,10 +940,11 @@ Reader::readString ()
 
 
 bool
-Reader::readObject ( Token& tokenStart )
+Reader::readObject ( Token& tokenStart, unsigned depth )
 {
     Token tokenName;
     std::string name;
+    DocumentHasher hasher ( objectValue );
     currentValue () = Value ( objectValue );
 
     while ( readToken ( tokenName ) )
@@ -444,7 +958,12 @@ Reader::readObject ( Token& tokenStart )
             break;
 
         if ( tokenName.type_ == tokenObjectEnd  &&  name.empty () ) // empty object
+        {
+            if ( hashing_ )
+                hashes_.push_back ( hasher.finish () );
+
             return true;
+        }
 
         if ( tokenName.type_ != tokenString )
             break;
@@ -463,18 +982,42 @@ Reader::readObject ( Token& tokenStart )
                                         tokenObjectEnd );
         }
 
-        // Reject duplicate names
-        if (currentValue ().isMember (name))
+        // Reject duplicate names. Inserting and checking whether the object
+        // grew costs a single member lookup rather than two.
+        Value& object = currentValue ();
+        auto const members = object.size ();
+        Value& value = object[ name ];
+
+        if ( object.size () == members )
             return addError ( "Key '" + name + "' appears twice.", tokenName );
 
-        Value& value = currentValue ()[ name ];
+        // Index a wide object from the member that takes it to the
+        // threshold, starting with those already read. Value stores a
+        // name up to its first NUL, and so does the index.
+        if ( indexThreshold_  &&  object.size () >= indexThreshold_ )
+        {
+            auto const found = memberIndexes_.find ( &object );
+
+            if ( found == memberIndexes_.end () )
+                memberIndexes_.emplace ( &object, MemberIndex ( object ) );
+            else
+                found->second.insert ( name.c_str (),
+                    std::strlen ( name.c_str () ), value );
+        }
+
         nodes_.push ( &value );
-        bool ok = readValue ();
+        bool ok = readValue ( depth + 1 );
         nodes_.pop ();
 
         if ( !ok ) // error already set
             return recoverFromError ( tokenObjectEnd );
 
+        if ( hashing_ )
+        {
+            hasher.addMember ( name, hashes_.back () );
+            hashes_.pop_back ();
+        }
+
         Token comma;
 
         if ( !readToken ( comma )
@@ -494,7 +1037,12 @@ Reader::readObject ( Token& tokenStart )
             finalizeTokenOk = readToken ( comma );
 
         if ( comma.type_ == tokenObjectEnd )
+        {
+            if ( hashing_ )
+                hashes_.push_back ( hasher.finish () );
+
             return true;
+        }
     }
 
     return addErrorAndRecover ( "Missing '}' or object member name",
@@ -504,15 +1052,20 @@ Reader::readObject ( Token& tokenStart )
 
 
 bool
-Reader::readArray ( Token& tokenStart )
+Reader::readArray ( Token& tokenStart, unsigned depth )
 {
+    DocumentHasher hasher ( arrayValue );
     currentValue () = Value ( arrayValue );
     skipSpaces ();
 
-    if ( *current_ == ']' ) // empty array
+    if ( current_ != end_  &&  *current_ == ']' ) // empty array
     {
         Token endArray;
         readToken ( endArray );
+
+        if ( hashing_ )
+            hashes_.push_back ( hasher.finish () );
+
         return true;
     }
 
@@ -522,12 +1075,18 @@ Reader::readArray ( Token& tokenStart )
     {
         Value& value = currentValue ()[ index++ ];
         nodes_.push ( &value );
-        bool ok = readValue ();
+        bool ok = readValue ( depth + 1 );
         nodes_.pop ();
 
         if ( !ok ) // error already set
             return recoverFromError ( tokenArrayEnd );
 
+        if ( hashing_ )
+        {
+            hasher.addElement ( hashes_.back () );
+            hashes_.pop_back ();
+        }
+
         Token token;
         // Accept Comment after last item in the array.
         ok = readToken ( token );
@@ -551,6 +1110,9 @@ Reader::readArray ( Token& tokenStart )
             break;
     }
 
+    if ( hashing_ )
+        hashes_.push_back ( hasher.finish () );
+
     return true;
 }
 
@@ -668,23 +1230,74 @@ Reader::decodeString ( Token& token )
 {
     std::string decoded;
 
+    streamedString_ = stringHandler_  &&
+        std::size_t ( token.end_ - token.start_ ) >= stringThreshold_;
+
+    if ( streamedString_ )
+    {
+        // The handler may assign the target anything, so the document hash
+        // is taken over the chunks as they are decoded.
+        Value& target = currentValue ();
+        target = "";
+        streamHash_ = StringHasher ();
+        return decodeString ( token, decoded, &target );
+    }
+
     if ( !decodeString ( token, decoded ) )
         return false;
 
-    currentValue () = decoded;
+    // A StaticString ends at the first NUL, so such strings are not pooled.
+    if ( stringPool_  &&  decoded.find ( '\0' ) == std::string::npos )
+        currentValue () = Value ( stringPool_->intern ( decoded ) );
+    else
+        currentValue () = decoded;
+
     return true;
 }
 
 
 bool
-Reader::decodeString ( Token& token, std::string& decoded )
+Reader::decodeString ( Token& token, std::string& decoded,
+                       Value* streamTarget )
 {
-    decoded.reserve ( token.end_ - token.start_ - 2 );
     Location current = token.start_ + 1; // skip '"'
     Location end = token.end_ - 1;      // do not include '"'
 
+    // When streaming, decoded holds at most one chunk at a time.
+    std::size_t const capacity = streamTarget ?
+        std::min<std::size_t> ( end - current, stream_chunk_size ) :
+        end - current;
+    decoded.reserve ( capacity );
+
     while ( current != end )
     {
+        if ( streamTarget  &&  decoded.size () >= stream_chunk_size )
+        {
+            if ( hashing_ )
+                streamHash_.append ( decoded.data (), decoded.size () );
+
+            stringHandler_ ( *streamTarget, decoded.data (), decoded.size (),
+                false );
+            decoded.clear ();
+        }
+
+        // Copy the run of characters needing no unescaping in one step,
+        // stopping at the end of the chunk when streaming.
+        Location run = current;
+        Location limit = end;
+
+        if ( streamTarget  &&  std::size_t ( end - current ) >
+                stream_chunk_size - decoded.size () )
+            limit = current + ( stream_chunk_size - decoded.size () );
+
+        while ( current != limit  &&  *current != '"'  &&  *current != '\\' )
+            ++current;
+
+        decoded.append ( run, current );
+
+        if ( current == limit )
+            continue;
+
         Char c = *current++;
 
         if ( c == '"' )
@@ -745,10 +1358,14 @@ Reader::decodeString ( Token& token, std::string& decoded )
                 return addError ( "Bad escape sequence in string", token, current );
             }
         }
-        else
-        {
-            decoded += c;
-        }
+    }
+
+    if ( streamTarget )
+    {
+        if ( hashing_ )
+            streamHash_.append ( decoded.data (), decoded.size () );
+
+        stringHandler_ ( *streamTarget, decoded.data (), decoded.size (), true );
     }
 
     return true;
@@ -828,6 +1445,7 @@ Reader::addError ( std::string const& message,
     info.message_ = message;
     info.extra_ = extra;
     errors_.push_back ( info );
+    JSON_READER_PROBE2 (error, token.start_ - begin_, message.c_str ());
     return false;
 }
 
@@ -836,6 +1454,7 @@ bool
 Reader::recoverFromError ( TokenType skipUntilToken )
 {
     int errorCount = int (errors_.size ());
+    Location const recoverStart = current_;
     Token skip;
 
     while ( true )
@@ -848,6 +1467,7 @@ Reader::recoverFromError ( TokenType skipUntilToken )
     }
 
     errors_.resize ( errorCount );
+    JSON_READER_PROBE2 (recover, recoverStart - begin_, current_ - recoverStart);
     return false;
 }
 
@@ -894,7 +1514,7 @@ Reader::getLocationLineAndColumn ( Location location,
 
         if ( c == '\r' )
         {
-            if ( *current == '\n' )
+            if ( current != end_  &&  *current == '\n' )
                 ++current;
 
             lastLineStart = current;
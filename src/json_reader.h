@@ -24,8 +24,18 @@
 
 #include <ripple/json/json_forwards.h>
 #include <ripple/json/json_value.h>
+#include <json_document_hash.h>
+#include <json_member_index.h>
+#include <json_string_pool.h>
 #include <boost/asio/buffer.hpp>
+#include <functional>
 #include <stack>
+#include <unordered_map>
+#include <vector>
+
+namespace ripple {
+class json_reader_test;
+}
 
 namespace Json
 {
@@ -60,6 +70,53 @@ public:
      */
     bool parse ( const char* beginDoc, const char* endDoc, Value& root);
 
+    /** \brief Read a Value from a <a HREF="http://www.json.org">JSON</a> document,
+     *         building the elements of a top-level array concurrently.
+     *
+     * The elements, of any type, are located with a StructuralIndex and
+     * parsed on \a threads threads, then assembled into \a root in order.
+     * Documents that are not a top-level array, that contain comments,
+     * that have fewer elements than threads, or that fail to parse are
+     * read sequentially instead, as are all documents while a
+     * StringChunkHandler is set or members are indexed. The result and any
+     * errors reported by
+     * getFormatedErrorMessages() are therefore those of
+     * parse(beginDoc, endDoc, root).
+     */
+    bool parse ( const char* beginDoc, const char* endDoc, Value& root,
+                 unsigned threads );
+
+    /** \brief Read the elements of a top-level array into contiguous storage.
+     *
+     * Value keeps array elements in a tree keyed by index, costing a node
+     * allocation and a logarithmic insertion per element. Reading into a
+     * vector instead appends each element in constant time and gives
+     * constant time indexed access and cache friendly iteration.
+     * \param elements [out] The elements of the array, in order.
+     * \param threads Number of threads to build the elements with. Arrays
+     *        of objects, arrays and scalars alike are split between them,
+     *        with the same sequential fallbacks as
+     *        parse(beginDoc, endDoc, root, threads).
+     * \return \c true if the document is an array that was successfully
+     *         parsed, \c false if an error occurred.
+     */
+    bool parse ( const char* beginDoc, const char* endDoc,
+                 std::vector<Value>& elements, unsigned threads = 1 );
+
+    /** \brief Read a Value from a base64 encoded <a HREF="http://www.json.org">JSON</a>
+     *         document, such as a validator token.
+     *
+     * The text is decoded straight into the buffer the reader parses from,
+     * avoiding an intermediate copy of the decoded document.
+     * \param encoded Base64 text, which may be wrapped across lines.
+     * \param root [out] Contains the root value of the document if it was
+     *             successfully parsed.
+     * \return \c true if the document was successfully decoded and parsed,
+     *         \c false if an error occurred.
+     * \see base64Decode
+     */
+    bool parseBase64 ( std::string const& encoded, Value& root );
+
     /// \brief Parse from input stream.
     /// \see Json::operator>>(std::istream&, Json::Value&).
     bool parse ( std::istream& is, Value& root);
@@ -74,6 +131,120 @@ public:
     bool
     parse(Value& root, BufferSequence const& bs);
 
+    /** \brief Read a single value of any type.
+     *
+     * Unlike parse(), the value need not be an array or an object. This
+     * reads one element or member of a larger document, for example one
+     * located through a StructuralIndex, and anything but whitespace or
+     * comments after the value is an error.
+     * \param value [out] Contains the value if it was successfully parsed.
+     * \return \c true if the value was successfully parsed, \c false if an
+     *         error occurred.
+     */
+    bool parseValue ( const char* beginDoc, const char* endDoc, Value& value );
+
+    /** \brief Start reading the elements of a top-level array one at a time.
+     *
+     * Only the element currently being read is held in memory, so huge
+     * arrays can be consumed with constant memory by calling nextElement()
+     * until it returns \c false.
+     * \param document UTF-8 encoded string whose root is an array.
+     * \return \c true if the document opens with an array, \c false if an
+     *         error occurred.
+     */
+    bool beginArray ( std::string const& document );
+
+    /** \brief Start reading the elements of a top-level array one at a time.
+     * \see beginArray(std::string const&)
+     */
+    bool beginArray ( const char* beginDoc, const char* endDoc );
+
+    /** \brief Read the next element of the array opened by beginArray().
+     * \param element [out] Contains the next element if one was read.
+     * \return \c true if an element was read, \c false once the end of the
+     *         array is reached or if an error occurred. Use good() to tell
+     *         the two apart.
+     */
+    bool nextElement ( Value& element );
+
+    /** \brief Return whether there are any errors.
+     * \return \c true if there are no errors to report, \c false if
+     *         errors have occurred.
+     */
+    bool good () const;
+
+    /** \brief Share decoded string values through \a pool.
+     *
+     * While a pool is set, each string value is stored once in the pool and
+     * referenced from the Value, rather than allocated per Value. Member
+     * names are not pooled, since copies of an object would keep referring
+     * to them. Pass \c nullptr to stop pooling. Elements built concurrently by parse(beginDoc, endDoc, root, threads)
+     * do not use the pool.
+     * \see StringPool
+     */
+    void setStringPool ( StringPool* pool );
+
+    /** \brief Receives a string value in decoded chunks.
+     * \param target The Value the string would have been stored in.
+     * \param data, size The next chunk of the decoded string.
+     * \param last \c true for the final chunk.
+     */
+    using StringChunkHandler = std::function<void (
+        Value& target, const char* data, std::size_t size, bool last)>;
+
+    /** \brief Stream large string values to \a handler instead of storing them.
+     *
+     * String values whose encoded length is at least \a threshold bytes
+     * are decoded in chunks of bounded size and passed to \a handler, so a
+     * multi-megabyte field can be fed straight into a hasher, decoder or
+     * file without being held in memory as a whole. The target Value is
+     * set to an empty string first and the handler may assign it, for
+     * example to a digest. Member names are never streamed. If an error
+     * occurs part way through a string, its final chunk is not delivered.
+     *
+     * This applies to parse() and nextElement(). Documents read with
+     * several threads are read sequentially while a handler is set. Pass
+     * an empty handler to stop streaming.
+     *
+     * With enableDocumentHash(), a streamed string is hashed by its decoded
+     * content, exactly as if it had been stored, whatever the handler
+     * leaves in the target.
+     */
+    void streamLargeStrings ( std::size_t threshold, StringChunkHandler handler );
+
+    /** \brief Index the members of wide objects as they are read.
+     *
+     * While \a threshold is non-zero, each object that reaches \a threshold
+     * members is given a MemberIndex, which is filled in as the rest of its
+     * member names are decoded. Lookups by name in such objects then take
+     * constant time through memberIndex(). Pass 0 to stop indexing.
+     */
+    void indexMembers ( std::size_t threshold );
+
+    /** \brief Returns the index built for \a object by the last parse.
+     *
+     * \a object is a Value within the document last parsed, or within the
+     * element last read by nextElement(), left where the parse put it.
+     * \return The index, or \c nullptr if the object had fewer members
+     *         than the threshold or the parse failed.
+     */
+    MemberIndex const* memberIndex ( Value const& object ) const;
+
+    /** \brief Compute a canonical hash of each document parsed.
+     *
+     * While enabled, parsing into a Value also computes the document's
+     * DocumentHash incrementally as each container closes. Documents that
+     * differ only in formatting or member order hash equal, so they can be
+     * deduplicated in a single parse pass without canonical re-serialization.
+     */
+    void enableDocumentHash ( bool enable );
+
+    /** \brief Returns the hash of the last document parsed into a Value.
+     * \return The hash, or a zero hash if hashing is disabled or the last
+     *         parse failed or did not produce a single root value.
+     */
+    DocumentHash documentHash () const;
+
     /** \brief Returns a user friendly string that list errors in the parsed document.
      * \return Formatted error message with the list of errors with their location in
      *         the parsed document. An empty string is returned if no error occurred
@@ -82,6 +253,18 @@ public:
     std::string getFormatedErrorMessages () const;
 
 private:
+    friend class StructReader;
+    friend class ripple::json_reader_test;
+
+    /** Maximum depth to which objects and arrays may nest.
+        Deeper documents are rejected rather than recursed into, so a
+        hostile payload cannot exhaust the stack.
+    */
+    static constexpr unsigned nest_limit {25};
+
+    /** Largest chunk of a streamed string passed to the handler at once. */
+    static constexpr std::size_t stream_chunk_size {64 * 1024};
+
     enum TokenType
     {
         tokenEndOfStream = 0,
@@ -119,6 +302,14 @@ private:
 
     using Errors = std::deque<ErrorInfo>;
 
+    enum ArrayState
+    {
+        arrayNone = 0,
+        arrayFirst,
+        arrayMore,
+        arrayDone
+    };
+
     bool expectToken ( TokenType type, Token& token, const char* message );
     bool readToken ( Token& token );
     void skipSpaces ();
@@ -129,12 +320,18 @@ private:
     bool readCppStyleComment ();
     bool readString ();
     Reader::TokenType readNumber ();
-    bool readValue ();
-    bool readObject ( Token& token );
-    bool readArray ( Token& token );
+    bool readElementsConcurrently ( const char* beginDoc, const char* endDoc,
+                                    std::vector<Value>& elements,
+                                    unsigned threads );
+    bool readElement ( const char* beginDoc, const char* endDoc,
+                       Value& element, unsigned depth );
+    bool readValue ( unsigned depth );
+    bool readObject ( Token& token, unsigned depth );
+    bool readArray ( Token& token, unsigned depth );
     bool decodeNumber ( Token& token );
     bool decodeString ( Token& token );
-    bool decodeString ( Token& token, std::string& decoded );
+    bool decodeString ( Token& token, std::string& decoded,
+                        Value* streamTarget = nullptr );
     bool decodeDouble ( Token& token );
     bool decodeUnicodeCodePoint ( Token& token,
                                   Location& current,
@@ -159,6 +356,10 @@ private:
                                     int& column ) const;
     std::string getLocationLineAndColumn ( Location location ) const;
     void skipCommentTokens ( Token& token );
+    void abandonArray ();
+    void probeParseBegin ( Location beginDoc, Location endDoc ) const;
+    void probeParseEnd ( Location beginDoc, Location endDoc,
+                         bool successful ) const;
 
     using Nodes = std::stack<Value*>;
     Nodes nodes_;
@@ -169,6 +370,16 @@ private:
     Location current_;
     Location lastValueEnd_;
     Value* lastValue_;
+    ArrayState arrayState_;
+    StringPool* stringPool_;
+    std::size_t stringThreshold_;
+    StringChunkHandler stringHandler_;
+    bool streamedString_;
+    StringHasher streamHash_;
+    bool hashing_;
+    std::vector<DocumentHash> hashes_;
+    std::size_t indexThreshold_;
+    std::unordered_map<Value const*, MemberIndex> memberIndexes_;
 };
 
 template<class BufferSequence>
@@ -176,11 +387,14 @@ bool
 Reader::parse(Value& root, BufferSequence const& bs)
 {
     using namespace boost::asio;
-    std::string s;
-    s.reserve (buffer_size(bs));
+    // Assemble the buffers directly into the document the reader keeps
+    // for error reporting, rather than copying them twice.
+    document_.clear ();
+    document_.reserve (buffer_size(bs));
     for (auto const& b : bs)
-        s.append(buffer_cast<char const*>(b), buffer_size(b));
-    return parse(s, root);
+        document_.append(buffer_cast<char const*>(b), buffer_size(b));
+    const char* begin = document_.c_str ();
+    return parse(begin, begin + document_.length (), root);
 }
 
 /** \brief Read from 'sin' into 'root'.
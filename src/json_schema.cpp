@@ -0,0 +1,408 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_schema.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace Json
+{
+
+namespace {
+
+Schema::Kind
+kindOf ( Value const& value )
+{
+    switch ( value.type () )
+    {
+    case nullValue:
+        return Schema::nullKind;
+
+    case intValue:
+        return value.asInt () < 0 ? Schema::intKind : Schema::uintKind;
+
+    case uintValue:
+        return Schema::uintKind;
+
+    case realValue:
+        return Schema::realKind;
+
+    case stringValue:
+        return Schema::stringKind;
+
+    case booleanValue:
+        return Schema::boolKind;
+
+    case arrayValue:
+        return Schema::arrayKind;
+
+    case objectValue:
+        return Schema::objectKind;
+    }
+
+    return Schema::anyKind;
+}
+
+bool
+isNumber ( Schema::Kind kind )
+{
+    return kind == Schema::intKind  ||  kind == Schema::uintKind  ||
+           kind == Schema::realKind;
+}
+
+Schema::Kind
+widen ( Schema::Kind a, Schema::Kind b )
+{
+    if ( a == Schema::unknownKind  ||  a == b )
+        return b;
+
+    if ( isNumber ( a )  &&  isNumber ( b ) )
+    {
+        if ( a == Schema::realKind  ||  b == Schema::realKind )
+            return Schema::realKind;
+
+        return Schema::intKind;
+    }
+
+    return Schema::anyKind;
+}
+
+// A C++ string literal holding s.
+std::string
+quote ( std::string const& s )
+{
+    std::string result = "\"";
+
+    for ( unsigned char c : s )
+    {
+        if ( c == '"'  ||  c == '\\' )
+        {
+            result += '\\';
+            result += c;
+        }
+        else if ( c < 0x20  ||  c >= 0x7f )
+        {
+            char escape[5];
+            std::snprintf ( escape, sizeof ( escape ), "\\%03o", c );
+            result += escape;
+        }
+        else
+        {
+            result += c;
+        }
+    }
+
+    return result + "\"";
+}
+
+// s, or s with the smallest suffix that makes it distinct from those in
+// used, which it is then added to.
+std::string
+unique ( std::string const& s, std::vector<std::string>& used )
+{
+    std::string result = s;
+
+    for ( int n = 2; std::find ( used.begin (), used.end (), result ) != used.end (); ++n )
+        result = s + "_" + std::to_string ( n );
+
+    used.push_back ( result );
+    return result;
+}
+
+// A C++ identifier for the member named s, distinct from those in used.
+std::string
+identifier ( std::string const& s, std::vector<std::string>& used )
+{
+    // C++ keywords and alternative tokens, including those reserved by
+    // later standards.
+    static char const* const keywords[] =
+    {
+        "alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand",
+        "bitor", "bool", "break", "case", "catch", "char", "char8_t",
+        "char16_t", "char32_t", "class", "compl", "concept", "const",
+        "consteval", "constexpr", "constinit", "const_cast", "continue",
+        "co_await", "co_return", "co_yield", "decltype", "default",
+        "delete", "do", "double", "dynamic_cast", "else", "enum",
+        "explicit", "export", "extern", "false", "float", "for", "friend",
+        "goto", "if", "inline", "int", "long", "mutable", "namespace",
+        "new", "noexcept", "not", "not_eq", "nullptr", "operator", "or",
+        "or_eq", "private", "protected", "public", "register",
+        "reinterpret_cast", "requires", "return", "short", "signed",
+        "sizeof", "static", "static_assert", "static_cast", "struct",
+        "switch", "template", "this", "thread_local", "throw", "true",
+        "try", "typedef", "typeid", "typename", "union", "unsigned",
+        "using", "virtual", "void", "volatile", "wchar_t", "while", "xor",
+        "xor_eq"
+    };
+
+    std::string id;
+
+    // Map other characters to '_', without forming the reserved "__".
+    for ( unsigned char c : s )
+    {
+        bool const alnum = ( c >= 'a'  &&  c <= 'z' )  ||
+            ( c >= 'A'  &&  c <= 'Z' )  ||  ( c >= '0'  &&  c <= '9' );
+
+        if ( alnum )
+            id += static_cast<char> ( c );
+        else if ( id.empty ()  ||  id.back () != '_' )
+            id += '_';
+    }
+
+    // Names may not start with a digit, and those starting with '_' are
+    // reserved in places.
+    if ( id.empty ()  ||  id[0] == '_'  ||
+            ( id[0] >= '0'  &&  id[0] <= '9' ) )
+        id = "m" + id;
+
+    if ( std::find_if ( std::begin ( keywords ), std::end ( keywords ),
+            [&] ( char const* k ) { return id == k; } ) != std::end ( keywords ) )
+        id += '_';
+
+    return unique ( id, used );
+}
+
+} // namespace
+
+Schema::Schema ()
+    : kind_ (unknownKind)
+    , nullable_ (false)
+    , objects_ (0)
+{
+}
+
+Schema
+Schema::infer ( std::vector<Value> const& samples )
+{
+    Schema schema;
+
+    for ( auto const& sample : samples )
+        schema.observe ( sample );
+
+    return schema;
+}
+
+void
+Schema::observe ( Value const& value )
+{
+    Kind const kind = kindOf ( value );
+
+    if ( kind == nullKind )
+    {
+        nullable_ = true;
+
+        if ( kind_ == unknownKind )
+            kind_ = nullKind;
+
+        return;
+    }
+
+    if ( kind_ == nullKind )
+    {
+        nullable_ = true;
+        kind_ = unknownKind;
+    }
+
+    kind_ = widen ( kind_, kind );
+
+    if ( kind_ == anyKind )
+    {
+        members_.clear ();
+        element_.clear ();
+        return;
+    }
+
+    if ( kind_ == arrayKind )
+    {
+        for ( Value::UInt i = 0; i < value.size (); ++i )
+        {
+            if ( element_.empty () )
+                element_.emplace_back ();
+
+            element_.front ().observe ( value[i] );
+        }
+    }
+    else if ( kind_ == objectKind )
+    {
+        ++objects_;
+
+        for ( auto it = value.begin (); it != value.end (); ++it )
+        {
+            std::string const name = it.memberName ();
+            auto member = std::find_if ( members_.begin (), members_.end (),
+                [&] ( Member const& m ) { return m.name == name; } );
+
+            if ( member == members_.end () )
+            {
+                members_.push_back ( Member { name, Schema (), 0, false } );
+                member = members_.end () - 1;
+            }
+
+            member->schema.observe ( *it );
+            ++member->seen;
+        }
+
+        for ( auto& member : members_ )
+            member.optional = member.seen < objects_;
+    }
+}
+
+std::string
+Schema::generate ( std::string const& typeName ) const
+{
+    std::string structs;
+    std::string bindings;
+    std::string alias;
+    std::vector<std::string> typeNames { typeName };
+
+    if ( kind_ == objectKind  &&  !nullable_ )
+    {
+        generateStruct ( typeName, structs, bindings, typeNames );
+    }
+    else if ( kind_ == arrayKind  &&  !nullable_  &&  element ()  &&
+            element ()->kind_ == objectKind  &&  !element ()->nullable_ )
+    {
+        std::string const elementName =
+            unique ( typeName + "Element", typeNames );
+        element ()->generateStruct ( elementName, structs, bindings, typeNames );
+        alias = "using " + typeName + " = std::vector<" + elementName +
+            ">;\n\n";
+    }
+    else
+    {
+        return std::string ();
+    }
+
+    return
+        "// Generated by Json::Schema::generate (). Do not edit.\n"
+        "\n"
+        "#include <ripple/json/json_value.h>\n"
+        "#include <json_binding.h>\n"
+        "#include <string>\n"
+        "#include <tuple>\n"
+        "#include <vector>\n"
+        "\n" +
+        structs +
+        alias +
+        "namespace Json\n"
+        "{\n"
+        "\n" +
+        bindings +
+        "} // namespace Json\n";
+}
+
+void
+Schema::generateStruct ( std::string const& typeName,
+                         std::string& structs, std::string& bindings,
+                         std::vector<std::string>& typeNames ) const
+{
+    // A member may not share the name of its struct.
+    std::vector<std::string> used { typeName };
+    std::vector<std::string> ids;
+    std::vector<std::string> types;
+
+    for ( auto const& member : members_ )
+    {
+        ids.push_back ( identifier ( member.name, used ) );
+        types.push_back ( member.schema.generateType (
+            typeName + "_" + ids.back (), structs, bindings, typeNames ) );
+    }
+
+    structs += "struct " + typeName + "\n{\n";
+
+    for ( std::size_t i = 0; i < members_.size (); ++i )
+        structs += "    " + types[i] + " " + ids[i] + " {};\n";
+
+    structs += "};\n\n";
+
+    bindings +=
+        "template <>\n"
+        "struct Binding<" + typeName + ">\n"
+        "{\n"
+        "    static constexpr auto fields ()\n"
+        "    {\n"
+        "        return std::make_tuple (";
+
+    for ( std::size_t i = 0; i < members_.size (); ++i )
+    {
+        bindings += ( i == 0 ) ? "\n" : ",\n";
+        bindings += "            field ( " + quote ( members_[i].name ) +
+            ", &" + typeName + "::" + ids[i] +
+            ( members_[i].optional ? ", true )" : " )" );
+    }
+
+    bindings +=
+        " );\n"
+        "    }\n"
+        "};\n"
+        "\n";
+}
+
+std::string
+Schema::generateType ( std::string const& typeName,
+                       std::string& structs, std::string& bindings,
+                       std::vector<std::string>& typeNames ) const
+{
+    // Only Value can also hold null.
+    if ( nullable_ )
+        return "Json::Value";
+
+    switch ( kind_ )
+    {
+    case boolKind:
+        return "bool";
+
+    case intKind:
+        return "int";
+
+    case uintKind:
+        return "unsigned";
+
+    case realKind:
+        return "double";
+
+    case stringKind:
+        return "std::string";
+
+    case arrayKind:
+        if ( !element () )
+            return "std::vector<Json::Value>";
+
+        return "std::vector<" +
+            element ()->generateType ( typeName, structs, bindings,
+                typeNames ) + ">";
+
+    case objectKind:
+    {
+        // Names built from different members can coincide, as for "b_c"
+        // and "b.c". Nested types are qualified, so members named like
+        // them do not hide them.
+        std::string const name = unique ( typeName, typeNames );
+        generateStruct ( name, structs, bindings, typeNames );
+        return "::" + name;
+    }
+
+    default:
+        return "Json::Value";
+    }
+}
+
+} // namespace Json
@@ -0,0 +1,129 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_SCHEMA_H_INCLUDED
+#define RIPPLE_JSON_JSON_SCHEMA_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace Json
+{
+
+/** \brief The shape of a family of JSON documents, inferred from samples.
+
+    Observing sample documents records, for each position in them, the
+    types seen there, the members of objects and how often each appears,
+    and the shape of array elements. Members missing from some samples are
+    optional; positions holding null, or values of unrelated types, are
+    left generic.
+
+    generate() turns the schema into C++ source declaring plain structs
+    and their Binding field tables, so a fixed-format feed is read by
+    StructReader with code specialized to it instead of through Value.
+*/
+class Schema
+{
+public:
+    enum Kind
+    {
+        unknownKind,    ///< Nothing observed yet, or only empty arrays
+        nullKind,       ///< Only null observed
+        boolKind,
+        intKind,        ///< Integers, some negative
+        uintKind,       ///< Non-negative integers
+        realKind,       ///< Numbers, some with a fraction or exponent
+        stringKind,
+        arrayKind,
+        objectKind,
+        anyKind         ///< Values of unrelated types
+    };
+
+    struct Member;
+
+    Schema ();
+
+    /// \brief Infer the schema shared by \a samples.
+    static Schema infer ( std::vector<Value> const& samples );
+
+    /// \brief Widen the schema to also describe \a value.
+    void observe ( Value const& value );
+
+    Kind kind () const
+    {
+        return kind_;
+    }
+
+    /// \brief Whether null was observed along with another kind.
+    bool nullable () const
+    {
+        return nullable_;
+    }
+
+    /// \brief The members of an object, in the order first observed.
+    std::vector<Member> const& members () const
+    {
+        return members_;
+    }
+
+    /// \brief The shape of the elements of an array, or \c nullptr.
+    Schema const* element () const
+    {
+        return element_.empty () ? nullptr : &element_.front ();
+    }
+
+    /** \brief Generate C++ source for structs holding documents of this
+     *         schema, and their Binding field tables.
+     *
+     * The root must be an object or an array of objects. The outermost
+     * type is named \a typeName; nested objects are named after it and the
+     * member that holds them.
+     */
+    std::string generate ( std::string const& typeName ) const;
+
+private:
+    void generateStruct ( std::string const& typeName,
+                          std::string& structs, std::string& bindings,
+                          std::vector<std::string>& typeNames ) const;
+    std::string generateType ( std::string const& typeName,
+                               std::string& structs,
+                               std::string& bindings,
+                               std::vector<std::string>& typeNames ) const;
+
+    Kind kind_;
+    bool nullable_;
+    std::size_t objects_;
+    std::vector<Member> members_;
+    std::vector<Schema> element_;
+};
+
+/// \brief A member of an object Schema.
+struct Schema::Member
+{
+    std::string name;
+    Schema schema;
+    std::size_t seen;       ///< Number of observed objects holding it
+    bool optional;          ///< Missing from some observed object
+};
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,983 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_serialized_writer.h>
+#include <json_base58.h>
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+
+namespace Json
+{
+
+namespace {
+
+// Serialized type codes.
+enum
+{
+    typeUInt16 = 1,
+    typeUInt32 = 2,
+    typeUInt64 = 3,
+    typeHash128 = 4,
+    typeHash256 = 5,
+    typeAmount = 6,
+    typeBlob = 7,
+    typeAccount = 8,
+    typeObject = 14,
+    typeArray = 15,
+    typeUInt8 = 16,
+    typeHash160 = 17,
+    typePathSet = 18,
+    typeVector256 = 19
+};
+
+// Ends of inner objects and arrays.
+int const endMarker = 1;
+
+// Matches the nesting Reader accepts, so all output reads back: the root
+// is at depth 0, members and elements one deeper than their container,
+// and no value may be deeper than this.
+unsigned const nestLimit = 25;
+
+struct Name
+{
+    std::uint16_t id;       // type << 8 | field code
+    char const* name;
+};
+
+constexpr
+std::uint16_t
+fieldId ( int type, int code )
+{
+    return static_cast<std::uint16_t> ( ( type << 8 ) | code );
+}
+
+// Field names, sorted by id.
+constexpr Name fieldNames[] =
+{
+    { fieldId ( typeUInt16, 1 ), "LedgerEntryType" },
+    { fieldId ( typeUInt16, 2 ), "TransactionType" },
+    { fieldId ( typeUInt16, 3 ), "SignerWeight" },
+
+    { fieldId ( typeUInt32, 2 ), "Flags" },
+    { fieldId ( typeUInt32, 3 ), "SourceTag" },
+    { fieldId ( typeUInt32, 4 ), "Sequence" },
+    { fieldId ( typeUInt32, 5 ), "PreviousTxnLgrSeq" },
+    { fieldId ( typeUInt32, 6 ), "LedgerSequence" },
+    { fieldId ( typeUInt32, 7 ), "CloseTime" },
+    { fieldId ( typeUInt32, 8 ), "ParentCloseTime" },
+    { fieldId ( typeUInt32, 9 ), "SigningTime" },
+    { fieldId ( typeUInt32, 10 ), "Expiration" },
+    { fieldId ( typeUInt32, 11 ), "TransferRate" },
+    { fieldId ( typeUInt32, 12 ), "WalletSize" },
+    { fieldId ( typeUInt32, 13 ), "OwnerCount" },
+    { fieldId ( typeUInt32, 14 ), "DestinationTag" },
+    { fieldId ( typeUInt32, 16 ), "HighQualityIn" },
+    { fieldId ( typeUInt32, 17 ), "HighQualityOut" },
+    { fieldId ( typeUInt32, 18 ), "LowQualityIn" },
+    { fieldId ( typeUInt32, 19 ), "LowQualityOut" },
+    { fieldId ( typeUInt32, 20 ), "QualityIn" },
+    { fieldId ( typeUInt32, 21 ), "QualityOut" },
+    { fieldId ( typeUInt32, 22 ), "StampEscrow" },
+    { fieldId ( typeUInt32, 23 ), "BondAmount" },
+    { fieldId ( typeUInt32, 24 ), "LoadFee" },
+    { fieldId ( typeUInt32, 25 ), "OfferSequence" },
+    { fieldId ( typeUInt32, 26 ), "FirstLedgerSequence" },
+    { fieldId ( typeUInt32, 27 ), "LastLedgerSequence" },
+    { fieldId ( typeUInt32, 28 ), "TransactionIndex" },
+    { fieldId ( typeUInt32, 29 ), "OperationLimit" },
+    { fieldId ( typeUInt32, 30 ), "ReferenceFeeUnits" },
+    { fieldId ( typeUInt32, 31 ), "ReserveBase" },
+    { fieldId ( typeUInt32, 32 ), "ReserveIncrement" },
+    { fieldId ( typeUInt32, 33 ), "SetFlag" },
+    { fieldId ( typeUInt32, 34 ), "ClearFlag" },
+    { fieldId ( typeUInt32, 35 ), "SignerQuorum" },
+    { fieldId ( typeUInt32, 36 ), "CancelAfter" },
+    { fieldId ( typeUInt32, 37 ), "FinishAfter" },
+    { fieldId ( typeUInt32, 38 ), "SignerListID" },
+    { fieldId ( typeUInt32, 39 ), "SettleDelay" },
+
+    { fieldId ( typeUInt64, 1 ), "IndexNext" },
+    { fieldId ( typeUInt64, 2 ), "IndexPrevious" },
+    { fieldId ( typeUInt64, 3 ), "BookNode" },
+    { fieldId ( typeUInt64, 4 ), "OwnerNode" },
+    { fieldId ( typeUInt64, 5 ), "BaseFee" },
+    { fieldId ( typeUInt64, 6 ), "ExchangeRate" },
+    { fieldId ( typeUInt64, 7 ), "LowNode" },
+    { fieldId ( typeUInt64, 8 ), "HighNode" },
+    { fieldId ( typeUInt64, 9 ), "DestinationNode" },
+
+    { fieldId ( typeHash128, 1 ), "EmailHash" },
+
+    { fieldId ( typeHash256, 1 ), "LedgerHash" },
+    { fieldId ( typeHash256, 2 ), "ParentHash" },
+    { fieldId ( typeHash256, 3 ), "TransactionHash" },
+    { fieldId ( typeHash256, 4 ), "AccountHash" },
+    { fieldId ( typeHash256, 5 ), "PreviousTxnID" },
+    { fieldId ( typeHash256, 6 ), "LedgerIndex" },
+    { fieldId ( typeHash256, 7 ), "WalletLocator" },
+    { fieldId ( typeHash256, 8 ), "RootIndex" },
+    { fieldId ( typeHash256, 9 ), "AccountTxnID" },
+    { fieldId ( typeHash256, 16 ), "BookDirectory" },
+    { fieldId ( typeHash256, 17 ), "InvoiceID" },
+    { fieldId ( typeHash256, 18 ), "Nickname" },
+    { fieldId ( typeHash256, 19 ), "Amendment" },
+    { fieldId ( typeHash256, 20 ), "TicketID" },
+    { fieldId ( typeHash256, 21 ), "Digest" },
+    { fieldId ( typeHash256, 22 ), "Channel" },
+
+    { fieldId ( typeAmount, 1 ), "Amount" },
+    { fieldId ( typeAmount, 2 ), "Balance" },
+    { fieldId ( typeAmount, 3 ), "LimitAmount" },
+    { fieldId ( typeAmount, 4 ), "TakerPays" },
+    { fieldId ( typeAmount, 5 ), "TakerGets" },
+    { fieldId ( typeAmount, 6 ), "LowLimit" },
+    { fieldId ( typeAmount, 7 ), "HighLimit" },
+    { fieldId ( typeAmount, 8 ), "Fee" },
+    { fieldId ( typeAmount, 9 ), "SendMax" },
+    { fieldId ( typeAmount, 10 ), "DeliverMin" },
+    { fieldId ( typeAmount, 16 ), "MinimumOffer" },
+    { fieldId ( typeAmount, 17 ), "RippleEscrow" },
+    { fieldId ( typeAmount, 18 ), "DeliveredAmount" },
+
+    { fieldId ( typeBlob, 1 ), "PublicKey" },
+    { fieldId ( typeBlob, 2 ), "MessageKey" },
+    { fieldId ( typeBlob, 3 ), "SigningPubKey" },
+    { fieldId ( typeBlob, 4 ), "TxnSignature" },
+    { fieldId ( typeBlob, 5 ), "Generator" },
+    { fieldId ( typeBlob, 6 ), "Signature" },
+    { fieldId ( typeBlob, 7 ), "Domain" },
+    { fieldId ( typeBlob, 8 ), "FundCode" },
+    { fieldId ( typeBlob, 9 ), "RemoveCode" },
+    { fieldId ( typeBlob, 10 ), "ExpireCode" },
+    { fieldId ( typeBlob, 11 ), "CreateCode" },
+    { fieldId ( typeBlob, 12 ), "MemoType" },
+    { fieldId ( typeBlob, 13 ), "MemoData" },
+    { fieldId ( typeBlob, 14 ), "MemoFormat" },
+    { fieldId ( typeBlob, 16 ), "Fulfillment" },
+    { fieldId ( typeBlob, 17 ), "Condition" },
+    { fieldId ( typeBlob, 18 ), "MasterSignature" },
+
+    { fieldId ( typeAccount, 1 ), "Account" },
+    { fieldId ( typeAccount, 2 ), "Owner" },
+    { fieldId ( typeAccount, 3 ), "Destination" },
+    { fieldId ( typeAccount, 4 ), "Issuer" },
+    { fieldId ( typeAccount, 5 ), "Authorize" },
+    { fieldId ( typeAccount, 6 ), "Unauthorize" },
+    { fieldId ( typeAccount, 7 ), "Target" },
+    { fieldId ( typeAccount, 8 ), "RegularKey" },
+
+    { fieldId ( typeObject, 2 ), "TransactionMetaData" },
+    { fieldId ( typeObject, 3 ), "CreatedNode" },
+    { fieldId ( typeObject, 4 ), "DeletedNode" },
+    { fieldId ( typeObject, 5 ), "ModifiedNode" },
+    { fieldId ( typeObject, 6 ), "PreviousFields" },
+    { fieldId ( typeObject, 7 ), "FinalFields" },
+    { fieldId ( typeObject, 8 ), "NewFields" },
+    { fieldId ( typeObject, 9 ), "TemplateEntry" },
+    { fieldId ( typeObject, 10 ), "Memo" },
+    { fieldId ( typeObject, 11 ), "SignerEntry" },
+    { fieldId ( typeObject, 16 ), "Signer" },
+    { fieldId ( typeObject, 18 ), "Majority" },
+
+    { fieldId ( typeArray, 3 ), "Signers" },
+    { fieldId ( typeArray, 4 ), "SignerEntries" },
+    { fieldId ( typeArray, 5 ), "Template" },
+    { fieldId ( typeArray, 6 ), "Necessary" },
+    { fieldId ( typeArray, 7 ), "Sufficient" },
+    { fieldId ( typeArray, 8 ), "AffectedNodes" },
+    { fieldId ( typeArray, 9 ), "Memos" },
+    { fieldId ( typeArray, 16 ), "Majorities" },
+
+    { fieldId ( typeUInt8, 1 ), "CloseResolution" },
+    { fieldId ( typeUInt8, 2 ), "Method" },
+    { fieldId ( typeUInt8, 3 ), "TransactionResult" },
+    { fieldId ( typeUInt8, 16 ), "TickSize" },
+
+    { fieldId ( typeHash160, 1 ), "TakerPaysCurrency" },
+    { fieldId ( typeHash160, 2 ), "TakerPaysIssuer" },
+    { fieldId ( typeHash160, 3 ), "TakerGetsCurrency" },
+    { fieldId ( typeHash160, 4 ), "TakerGetsIssuer" },
+
+    { fieldId ( typePathSet, 1 ), "Paths" },
+
+    { fieldId ( typeVector256, 1 ), "Indexes" },
+    { fieldId ( typeVector256, 2 ), "Hashes" },
+    { fieldId ( typeVector256, 3 ), "Amendments" },
+};
+
+constexpr
+bool
+sortedById ()
+{
+    for ( std::size_t i = 1; i < sizeof ( fieldNames ) / sizeof ( Name ); ++i )
+    {
+        if ( fieldNames[i - 1].id >= fieldNames[i].id )
+            return false;
+    }
+
+    return true;
+}
+
+static_assert ( sortedById (), "fieldNames must be sorted by id" );
+
+std::size_t const fieldCount = sizeof ( fieldNames ) / sizeof ( Name );
+
+// The index of a field in fieldNames, or fieldCount if it is unknown.
+std::size_t
+fieldIndex ( int type, int code )
+{
+    std::uint16_t const id = fieldId ( type, code );
+    auto const it = std::lower_bound ( std::begin ( fieldNames ),
+        std::end ( fieldNames ), id,
+        [] ( Name const& n, std::uint16_t i ) { return n.id < i; } );
+
+    if ( it == std::end ( fieldNames )  ||  it->id != id )
+        return fieldCount;
+
+    return it - std::begin ( fieldNames );
+}
+
+struct Code
+{
+    unsigned code;
+    char const* name;
+};
+
+Code const transactionTypes[] =
+{
+    { 0, "Payment" },
+    { 1, "EscrowCreate" },
+    { 2, "EscrowFinish" },
+    { 3, "AccountSet" },
+    { 4, "EscrowCancel" },
+    { 5, "SetRegularKey" },
+    { 6, "NickNameSet" },
+    { 7, "OfferCreate" },
+    { 8, "OfferCancel" },
+    { 10, "TicketCreate" },
+    { 11, "TicketCancel" },
+    { 12, "SignerListSet" },
+    { 13, "PaymentChannelCreate" },
+    { 14, "PaymentChannelFund" },
+    { 15, "PaymentChannelClaim" },
+    { 100, "EnableAmendment" },
+    { 101, "SetFee" },
+};
+
+Code const ledgerEntryTypes[] =
+{
+    { 'a', "AccountRoot" },
+    { 'd', "DirectoryNode" },
+    { 'f', "Amendments" },
+    { 'h', "LedgerHashes" },
+    { 'o', "Offer" },
+    { 'r', "RippleState" },
+    { 's', "FeeSettings" },
+    { 'u', "Escrow" },
+    { 'x', "PayChannel" },
+    { 'S', "SignerList" },
+    { 'T', "Ticket" },
+};
+
+// Results that can be recorded in metadata: success and claimed fees.
+Code const transactionResults[] =
+{
+    { 0, "tesSUCCESS" },
+    { 100, "tecCLAIM" },
+    { 101, "tecPATH_PARTIAL" },
+    { 102, "tecUNFUNDED_ADD" },
+    { 103, "tecUNFUNDED_OFFER" },
+    { 104, "tecUNFUNDED_PAYMENT" },
+    { 105, "tecFAILED_PROCESSING" },
+    { 121, "tecDIR_FULL" },
+    { 122, "tecINSUF_RESERVE_LINE" },
+    { 123, "tecINSUF_RESERVE_OFFER" },
+    { 124, "tecNO_DST" },
+    { 125, "tecNO_DST_INSUF_XRP" },
+    { 126, "tecNO_LINE_INSUF_RESERVE" },
+    { 127, "tecNO_LINE_REDUNDANT" },
+    { 128, "tecPATH_DRY" },
+    { 129, "tecUNFUNDED" },
+    { 130, "tecNO_ALTERNATIVE_KEY" },
+    { 131, "tecNO_REGULAR_KEY" },
+    { 132, "tecOWNERS" },
+    { 133, "tecNO_ISSUER" },
+    { 134, "tecNO_AUTH" },
+    { 135, "tecNO_LINE" },
+    { 136, "tecINSUFF_FEE" },
+    { 137, "tecFROZEN" },
+    { 138, "tecNO_TARGET" },
+    { 139, "tecNO_PERMISSION" },
+    { 140, "tecNO_ENTRY" },
+    { 141, "tecINSUFFICIENT_RESERVE" },
+    { 142, "tecNEED_MASTER_KEY" },
+    { 143, "tecDST_TAG_NEEDED" },
+    { 144, "tecINTERNAL" },
+    { 145, "tecOVERSIZE" },
+    { 146, "tecCRYPTOCONDITION_ERROR" },
+};
+
+template <std::size_t N>
+char const*
+codeName ( Code const (&codes)[N], unsigned code )
+{
+    for ( auto const& c : codes )
+    {
+        if ( c.code == code )
+            return c.name;
+    }
+
+    return nullptr;
+}
+
+char const hexDigits[] = "0123456789ABCDEF";
+
+std::uint64_t
+bigEndian ( std::uint8_t const* bytes, std::size_t count )
+{
+    std::uint64_t value = 0;
+
+    for ( std::size_t i = 0; i < count; ++i )
+        value = ( value << 8 ) | bytes[i];
+
+    return value;
+}
+
+} // namespace
+
+SerializedWriter::SerializedWriter ()
+    : begin_ (nullptr)
+    , current_ (nullptr)
+    , end_ (nullptr)
+{
+}
+
+bool
+SerializedWriter::write ( void const* data, std::size_t size )
+{
+    begin_ = static_cast<std::uint8_t const*> ( data );
+    current_ = begin_;
+    end_ = begin_ + size;
+    out_.clear ();
+    errors_.clear ();
+
+    return readObject ( true, 0 );
+}
+
+std::string
+SerializedWriter::getFormatedErrorMessages () const
+{
+    return errors_;
+}
+
+bool
+SerializedWriter::readObject ( bool root, unsigned depth )
+{
+    if ( depth > nestLimit )
+        return fail ( "Objects are nested too deeply." );
+
+    out_ += '{';
+    bool first = true;
+    std::bitset<fieldCount> seen;
+
+    // The root runs to the end of the buffer; inner objects to a marker.
+    while ( !root  ||  current_ != end_ )
+    {
+        int type;
+        int code;
+
+        if ( !readFieldId ( type, code ) )
+            return false;
+
+        if ( !root  &&  type == typeObject  &&  code == endMarker )
+            break;
+
+        std::size_t const index = fieldIndex ( type, code );
+
+        if ( index == fieldCount )
+            return fail ( "Unknown field with type " + std::to_string ( type ) +
+                " and code " + std::to_string ( code ) + "." );
+
+        char const* name = fieldNames[index].name;
+
+        // A serialized object holds each field at most once.
+        if ( seen[index] )
+            return fail ( std::string ( "Field '" ) + name + "' appears twice." );
+
+        seen[index] = true;
+
+        if ( !first )
+            out_ += ',';
+
+        first = false;
+        out_ += '"';
+        out_ += name;
+        out_ += "\":";
+
+        if ( !readField ( type, code, name, depth + 1 ) )
+            return false;
+    }
+
+    out_ += '}';
+    return true;
+}
+
+bool
+SerializedWriter::readArray ( unsigned depth )
+{
+    if ( depth > nestLimit )
+        return fail ( "Objects are nested too deeply." );
+
+    out_ += '[';
+    bool first = true;
+
+    for (;;)
+    {
+        int type;
+        int code;
+
+        if ( !readFieldId ( type, code ) )
+            return false;
+
+        if ( type == typeArray  &&  code == endMarker )
+            break;
+
+        std::size_t const index = fieldIndex ( type, code );
+
+        if ( type != typeObject  ||  index == fieldCount )
+            return fail ( "Array elements must be known objects." );
+
+        char const* name = fieldNames[index].name;
+
+        if ( !first )
+            out_ += ',';
+
+        // Each element is an object holding the named inner object.
+        first = false;
+        out_ += "{\"";
+        out_ += name;
+        out_ += "\":";
+
+        // The wrapper is one level down and the inner object two.
+        if ( !readObject ( false, depth + 2 ) )
+            return false;
+
+        out_ += '}';
+    }
+
+    out_ += ']';
+    return true;
+}
+
+bool
+SerializedWriter::readField ( int type, int code, char const* name,
+                              unsigned depth )
+{
+    std::uint8_t const* bytes;
+
+    if ( depth > nestLimit )
+        return fail ( "Objects are nested too deeply." );
+
+    switch ( type )
+    {
+    case typeUInt8:
+    case typeUInt16:
+    case typeUInt32:
+    {
+        std::size_t const size =
+            ( type == typeUInt8 ) ? 1 : ( type == typeUInt16 ) ? 2 : 4;
+
+        if ( !take ( size, bytes ) )
+            return false;
+
+        auto const value = static_cast<unsigned> ( bigEndian ( bytes, size ) );
+        char const* symbol = nullptr;
+
+        if ( type == typeUInt16  &&  code == 1 )
+            symbol = codeName ( ledgerEntryTypes, value );
+        else if ( type == typeUInt16  &&  code == 2 )
+            symbol = codeName ( transactionTypes, value );
+        else if ( type == typeUInt8  &&  code == 3 )
+            symbol = codeName ( transactionResults, value );
+
+        if ( symbol )
+        {
+            out_ += '"';
+            out_ += symbol;
+            out_ += '"';
+        }
+        else
+        {
+            appendNumber ( value );
+        }
+
+        return true;
+    }
+
+    case typeUInt64:
+        if ( !take ( 8, bytes ) )
+            return false;
+
+        out_ += '"';
+        appendHex ( bytes, 8 );
+        out_ += '"';
+        return true;
+
+    case typeHash128:
+    case typeHash160:
+    case typeHash256:
+    {
+        std::size_t const size =
+            ( type == typeHash128 ) ? 16 : ( type == typeHash160 ) ? 20 : 32;
+
+        if ( !take ( size, bytes ) )
+            return false;
+
+        out_ += '"';
+        appendHex ( bytes, size );
+        out_ += '"';
+        return true;
+    }
+
+    case typeAmount:
+        return readAmount ( depth );
+
+    case typeBlob:
+    {
+        std::size_t length;
+
+        if ( !readLength ( length )  ||  !take ( length, bytes ) )
+            return false;
+
+        out_ += '"';
+        appendHex ( bytes, length );
+        out_ += '"';
+        return true;
+    }
+
+    case typeAccount:
+    {
+        std::size_t length;
+
+        if ( !readLength ( length ) )
+            return false;
+
+        if ( length != 20 )
+            return fail ( std::string ( "Field '" ) + name +
+                "' is not a 20 byte account." );
+
+        if ( !take ( length, bytes ) )
+            return false;
+
+        appendAccount ( bytes );
+        return true;
+    }
+
+    case typeObject:
+        return readObject ( false, depth );
+
+    case typeArray:
+        return readArray ( depth );
+
+    case typePathSet:
+        return readPathSet ( depth );
+
+    case typeVector256:
+    {
+        std::size_t length;
+
+        if ( !readLength ( length ) )
+            return false;
+
+        if ( length % 32 != 0 )
+            return fail ( std::string ( "Field '" ) + name +
+                "' is not a whole number of hashes." );
+
+        if ( length != 0  &&  depth + 1 > nestLimit )
+            return fail ( "Objects are nested too deeply." );
+
+        if ( !take ( length, bytes ) )
+            return false;
+
+        out_ += '[';
+
+        for ( std::size_t i = 0; i < length; i += 32 )
+        {
+            if ( i != 0 )
+                out_ += ',';
+
+            out_ += '"';
+            appendHex ( bytes + i, 32 );
+            out_ += '"';
+        }
+
+        out_ += ']';
+        return true;
+    }
+    }
+
+    return fail ( std::string ( "Field '" ) + name + "' has an unknown type." );
+}
+
+bool
+SerializedWriter::readFieldId ( int& type, int& code )
+{
+    std::uint8_t const* bytes;
+
+    if ( !take ( 1, bytes ) )
+        return false;
+
+    type = bytes[0] >> 4;
+    code = bytes[0] & 0x0f;
+
+    // Codes of 16 or more follow in their own byte, type first.
+    if ( type == 0 )
+    {
+        if ( !take ( 1, bytes ) )
+            return false;
+
+        type = bytes[0];
+
+        if ( type < 16 )
+            return fail ( "Invalid field type encoding." );
+    }
+
+    if ( code == 0 )
+    {
+        if ( !take ( 1, bytes ) )
+            return false;
+
+        code = bytes[0];
+
+        if ( code < 16 )
+            return fail ( "Invalid field code encoding." );
+    }
+
+    return true;
+}
+
+bool
+SerializedWriter::readLength ( std::size_t& length )
+{
+    std::uint8_t const* bytes;
+
+    if ( !take ( 1, bytes ) )
+        return false;
+
+    std::size_t const b0 = bytes[0];
+
+    if ( b0 <= 192 )
+    {
+        length = b0;
+        return true;
+    }
+
+    if ( b0 <= 240 )
+    {
+        if ( !take ( 1, bytes ) )
+            return false;
+
+        length = 193 + ( b0 - 193 ) * 256 + bytes[0];
+        return true;
+    }
+
+    if ( b0 <= 254 )
+    {
+        if ( !take ( 2, bytes ) )
+            return false;
+
+        length = 12481 + ( b0 - 241 ) * 65536 + bytes[0] * 256 + bytes[1];
+        return true;
+    }
+
+    return fail ( "Invalid length prefix." );
+}
+
+bool
+SerializedWriter::readAmount ( unsigned depth )
+{
+    std::uint8_t const* bytes;
+
+    if ( !take ( 8, bytes ) )
+        return false;
+
+    std::uint64_t const raw = bigEndian ( bytes, 8 );
+    bool const native = ( raw & 0x8000000000000000ull ) == 0;
+    bool const positive = ( raw & 0x4000000000000000ull ) != 0;
+
+    if ( native )
+    {
+        out_ += positive ? "\"" : "\"-";
+        appendNumber ( raw & 0x3fffffffffffffffull );
+        out_ += '"';
+        return true;
+    }
+
+    std::uint8_t const* currency;
+    std::uint8_t const* issuer;
+
+    if ( depth + 1 > nestLimit )
+        return fail ( "Objects are nested too deeply." );
+
+    if ( !take ( 20, currency )  ||  !take ( 20, issuer ) )
+        return false;
+
+    std::uint64_t const mantissa = raw & 0x003fffffffffffffull;
+    int const exponent = static_cast<int> ( ( raw >> 54 ) & 0xff ) - 97;
+
+    out_ += "{\"currency\":";
+    appendCurrency ( currency );
+    out_ += ",\"issuer\":";
+    appendAccount ( issuer );
+    out_ += ",\"value\":\"";
+
+    if ( mantissa == 0 )
+    {
+        out_ += '0';
+    }
+    else
+    {
+        if ( !positive )
+            out_ += '-';
+
+        std::string const digits = std::to_string ( mantissa );
+
+        // As STAmount::getText: scientific outside a range of exponents,
+        // plain decimal without redundant zeros inside it.
+        if ( exponent != 0  &&  ( exponent < -25  ||  exponent > -5 ) )
+        {
+            out_ += digits;
+            out_ += 'e';
+            out_ += std::to_string ( exponent );
+        }
+        else
+        {
+            std::string const padded =
+                std::string ( 27, '0' ) + digits + std::string ( 23, '0' );
+            std::size_t const point = exponent + 43;
+
+            std::size_t first = padded.find_first_not_of ( '0' );
+            first = std::min ( first, point );
+
+            std::size_t last = padded.find_last_not_of ( '0' );
+            last = std::max<std::size_t> ( last + 1, point );
+
+            if ( first == point )
+                out_ += '0';
+            else
+                out_.append ( padded, first, point - first );
+
+            if ( last > point )
+            {
+                out_ += '.';
+                out_.append ( padded, point, last - point );
+            }
+        }
+    }
+
+    out_ += "\"}";
+    return true;
+}
+
+bool
+SerializedWriter::readPathSet ( unsigned depth )
+{
+    std::uint8_t const* bytes;
+    bool firstPath = true;
+
+    // The set holds paths, which hold element objects.
+    if ( depth + 1 > nestLimit )
+        return fail ( "Objects are nested too deeply." );
+
+    out_ += "[[";
+
+    for (;;)
+    {
+        if ( !take ( 1, bytes ) )
+            return false;
+
+        unsigned const kind = bytes[0];
+
+        // As in rippled, every path, including the only path of the set,
+        // must hold at least one element.
+        if ( ( kind == 0x00  ||  kind == 0xff )  &&  firstPath )
+            return fail ( "Empty path." );
+
+        if ( kind == 0x00 )       // end of the set
+            break;
+
+        if ( kind == 0xff )       // start of the next path
+        {
+            out_ += "],[";
+            firstPath = true;
+            continue;
+        }
+
+        if ( kind & ~0x31u )
+            return fail ( "Invalid path element type." );
+
+        if ( depth + 3 > nestLimit )
+            return fail ( "Objects are nested too deeply." );
+
+        if ( !firstPath )
+            out_ += ',';
+
+        firstPath = false;
+        out_ += '{';
+
+        if ( kind & 0x01 )
+        {
+            if ( !take ( 20, bytes ) )
+                return false;
+
+            out_ += "\"account\":";
+            appendAccount ( bytes );
+            out_ += ',';
+        }
+
+        if ( kind & 0x10 )
+        {
+            if ( !take ( 20, bytes ) )
+                return false;
+
+            out_ += "\"currency\":";
+            appendCurrency ( bytes );
+            out_ += ',';
+        }
+
+        if ( kind & 0x20 )
+        {
+            if ( !take ( 20, bytes ) )
+                return false;
+
+            out_ += "\"issuer\":";
+            appendAccount ( bytes );
+            out_ += ',';
+        }
+
+        std::uint8_t typeBytes[8] = { 0, 0, 0, 0, 0, 0, 0,
+            static_cast<std::uint8_t> ( kind ) };
+        out_ += "\"type\":";
+        appendNumber ( kind );
+        out_ += ",\"type_hex\":\"";
+        appendHex ( typeBytes, 8 );
+        out_ += "\"}";
+    }
+
+    out_ += "]]";
+    return true;
+}
+
+bool
+SerializedWriter::take ( std::size_t count, std::uint8_t const*& bytes )
+{
+    if ( std::size_t ( end_ - current_ ) < count )
+        return fail ( "Unexpected end of data." );
+
+    bytes = current_;
+    current_ += count;
+    return true;
+}
+
+void
+SerializedWriter::appendHex ( std::uint8_t const* bytes, std::size_t count )
+{
+    std::size_t const at = out_.size ();
+    out_.resize ( at + 2 * count );
+
+    for ( std::size_t i = 0; i < count; ++i )
+    {
+        out_[at + 2 * i] = hexDigits[bytes[i] >> 4];
+        out_[at + 2 * i + 1] = hexDigits[bytes[i] & 0x0f];
+    }
+}
+
+void
+SerializedWriter::appendAccount ( std::uint8_t const* bytes )
+{
+    out_ += '"';
+    base58CheckEncode ( tokenAccountId, bytes, 20, out_ );
+    out_ += '"';
+}
+
+void
+SerializedWriter::appendCurrency ( std::uint8_t const* bytes )
+{
+    static char const isoChars[] =
+        "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ"
+        "0123456789<>(){}[]|?!@#$%^&*";
+
+    auto const zero = [bytes] ( std::size_t from, std::size_t to )
+    {
+        return std::all_of ( bytes + from, bytes + to,
+            [] ( std::uint8_t b ) { return b == 0; } );
+    };
+
+    out_ += '"';
+
+    if ( zero ( 0, 20 ) )
+    {
+        out_ += "XRP";
+    }
+    else if ( zero ( 0, 19 )  &&  bytes[19] == 1 )
+    {
+        out_ += '1';            // noCurrency
+    }
+    else if ( zero ( 0, 12 )  &&  zero ( 15, 20 )  &&
+            std::all_of ( bytes + 12, bytes + 15, [] ( std::uint8_t b )
+                { return b != 0  &&  std::strchr ( isoChars, b ); } )  &&
+            std::memcmp ( bytes + 12, "XRP", 3 ) != 0 )
+    {
+        out_.append ( reinterpret_cast<char const*> ( bytes + 12 ), 3 );
+    }
+    else
+    {
+        appendHex ( bytes, 20 );
+    }
+
+    out_ += '"';
+}
+
+void
+SerializedWriter::appendNumber ( std::uint64_t value )
+{
+    char digits[20];
+    char* p = digits + sizeof ( digits );
+
+    do
+    {
+        *--p = static_cast<char> ( '0' + value % 10 );
+        value /= 10;
+    }
+    while ( value != 0 );
+
+    out_.append ( p, digits + sizeof ( digits ) );
+}
+
+bool
+SerializedWriter::fail ( std::string const& message )
+{
+    errors_ = "At offset " + std::to_string ( current_ - begin_ ) + ": " +
+        message + "\n";
+    return false;
+}
+
+} // namespace Json
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_SERIALIZED_WRITER_H_INCLUDED
+#define RIPPLE_JSON_JSON_SERIALIZED_WRITER_H_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Json
+{
+
+/** \brief Render binary-serialized ripple objects as JSON text.
+
+    Transactions, metadata and ledger entries arrive as the canonical
+    binary field stream. Rendering them for the APIs by deserializing into
+    objects and building a Value allocates for every field. SerializedWriter
+    instead walks the field stream once and writes JSON text into a buffer
+    it reuses, looking field names up in a constant table, so bulk exports
+    of ledger contents cost little more than reading the bytes.
+
+    The text has the same content as the Value produced by the objects'
+    getJson(), and reads back through Reader to an equal Value. Member
+    order follows the field stream. Fields missing from the table are
+    reported as errors rather than guessed, so callers can fall back to
+    the general path.
+*/
+class SerializedWriter
+{
+public:
+    SerializedWriter ();
+
+    /** \brief Render the serialized object in [\a data, \a data + \a size).
+     * \return \c true if the whole buffer was a well formed object made of
+     *         known fields.
+     */
+    bool write ( void const* data, std::size_t size );
+
+    /// \brief The text of the last object written.
+    std::string const& text () const
+    {
+        return out_;
+    }
+
+    /** \brief Returns a user friendly string describing the last error, or
+     *         an empty string.
+     */
+    std::string getFormatedErrorMessages () const;
+
+private:
+    bool readObject ( bool root, unsigned depth );
+    bool readArray ( unsigned depth );
+    bool readField ( int type, int code, char const* name, unsigned depth );
+    bool readFieldId ( int& type, int& code );
+    bool readLength ( std::size_t& length );
+    bool readAmount ( unsigned depth );
+    bool readPathSet ( unsigned depth );
+    bool take ( std::size_t count, std::uint8_t const*& bytes );
+
+    void appendHex ( std::uint8_t const* bytes, std::size_t count );
+    void appendAccount ( std::uint8_t const* bytes );
+    void appendCurrency ( std::uint8_t const* bytes );
+    void appendNumber ( std::uint64_t value );
+
+    bool fail ( std::string const& message );
+
+    std::uint8_t const* begin_;
+    std::uint8_t const* current_;
+    std::uint8_t const* end_;
+    std::string out_;
+    std::string errors_;
+};
+
+} // namespace Json
+
+#endif
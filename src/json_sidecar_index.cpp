@@ -0,0 +1,461 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_sidecar_index.h>
+#include <json_reader.h>
+#include <boost/filesystem.hpp>
+#include <algorithm>
+#include <fstream>
+
+namespace Json
+{
+
+namespace {
+
+char const magic[8] = { 'J', 'S', 'O', 'N', 'I', 'D', 'X', '1' };
+
+// Bytes hashed at each end of the file to detect changes that keep its
+// size and modification time.
+std::uint64_t const signatureSpan = 64 * 1024;
+
+std::size_t const chunkSize = 1024 * 1024;
+
+// Follows the elements of a top-level array as the document is fed
+// through it one byte at a time.
+class ArrayScanner
+{
+public:
+    enum Event
+    {
+        none,
+        elementBegin,   // this byte starts an element
+        elementEnd,     // the element ended before this byte
+        arrayEnd,       // this byte closes the array
+        bad             // not an array, or contains a comment
+    };
+
+    ArrayScanner ()
+        : depth_ (0)
+        , inString_ (false)
+        , escaped_ (false)
+        , expecting_ (false)
+    {
+    }
+
+    // Resume scanning at the position of an element.
+    void atElement ()
+    {
+        depth_ = 1;
+        inString_ = false;
+        escaped_ = false;
+        expecting_ = true;
+    }
+
+    Event feed ( char c )
+    {
+        if ( inString_ )
+        {
+            if ( escaped_ )
+                escaped_ = false;
+            else if ( c == '\\' )
+                escaped_ = true;
+            else if ( c == '"' )
+                inString_ = false;
+
+            return none;
+        }
+
+        if ( c == ' '  ||  c == '\t'  ||  c == '\r'  ||  c == '\n' )
+            return none;
+
+        if ( depth_ == 0 )
+        {
+            if ( c != '[' )
+                return bad;
+
+            depth_ = 1;
+            expecting_ = true;
+            return none;
+        }
+
+        Event event = none;
+
+        if ( depth_ == 1  &&  expecting_ )
+        {
+            if ( c == ']' ) // empty array
+            {
+                depth_ = 0;
+                return arrayEnd;
+            }
+
+            expecting_ = false;
+            event = elementBegin;
+        }
+
+        switch ( c )
+        {
+        case '"':
+            inString_ = true;
+            break;
+
+        case '{':
+        case '[':
+            ++depth_;
+            break;
+
+        case '}':
+        case ']':
+            if ( --depth_ == 0 )
+                return arrayEnd;
+            break;
+
+        case ',':
+            if ( depth_ == 1 )
+            {
+                expecting_ = true;
+                return elementEnd;
+            }
+            break;
+
+        case '/':
+            return bad;
+        }
+
+        return event;
+    }
+
+private:
+    int depth_;
+    bool inString_;
+    bool escaped_;
+    bool expecting_;
+};
+
+void
+hashBytes ( std::uint64_t& h, const char* data, std::size_t size )
+{
+    // 64-bit FNV-1a
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        h ^= static_cast<unsigned char> ( data[i] );
+        h *= 0x100000001b3ull;
+    }
+}
+
+void
+writeWord ( std::ostream& out, std::uint64_t word )
+{
+    char bytes[8];
+
+    for ( int i = 0; i < 8; ++i )
+        bytes[i] = static_cast<char> ( word >> ( 8 * i ) );
+
+    out.write ( bytes, sizeof ( bytes ) );
+}
+
+bool
+readWord ( std::istream& in, std::uint64_t& word )
+{
+    unsigned char bytes[8];
+
+    if ( !in.read ( reinterpret_cast<char*> ( bytes ), sizeof ( bytes ) ) )
+        return false;
+
+    word = 0;
+
+    for ( int i = 7; i >= 0; --i )
+        word = ( word << 8 ) | bytes[i];
+
+    return true;
+}
+
+} // namespace
+
+SidecarIndex::SidecarIndex ()
+    : signature_ {0, 0, 0}
+    , sampleEvery_ (1)
+    , count_ (0)
+{
+}
+
+bool
+SidecarIndex::build ( std::string const& path, std::string const& sidecarPath,
+                      std::size_t sampleEvery )
+{
+    errors_.clear ();
+    path_ = path;
+    sampleEvery_ = sampleEvery ? sampleEvery : 1;
+    count_ = 0;
+    samples_.clear ();
+
+    if ( !sign ( path, signature_ ) )
+        return false;
+
+    std::ifstream in ( path, std::ios::binary );
+    std::vector<char> buffer ( chunkSize );
+    ArrayScanner scanner;
+    std::uint64_t offset = 0;
+    bool complete = false;
+
+    while ( !complete  &&  in )
+    {
+        in.read ( buffer.data (), buffer.size () );
+        std::size_t const got = static_cast<std::size_t> ( in.gcount () );
+
+        for ( std::size_t i = 0; i < got  &&  !complete; ++i, ++offset )
+        {
+            switch ( scanner.feed ( buffer[i] ) )
+            {
+            case ArrayScanner::elementBegin:
+                if ( count_ % sampleEvery_ == 0 )
+                    samples_.push_back ( offset );
+
+                ++count_;
+                break;
+
+            case ArrayScanner::arrayEnd:
+                complete = true;
+                break;
+
+            case ArrayScanner::bad:
+                return fail ( "The document root must be an array without comments." );
+
+            default:
+                break;
+            }
+        }
+    }
+
+    if ( !complete )
+        return fail ( "The document is not a complete array." );
+
+    std::ofstream out ( sidecarPath, std::ios::binary | std::ios::trunc );
+    out.write ( magic, sizeof ( magic ) );
+    writeWord ( out, signature_.size );
+    writeWord ( out, signature_.modified );
+    writeWord ( out, signature_.hash );
+    writeWord ( out, sampleEvery_ );
+    writeWord ( out, count_ );
+    writeWord ( out, samples_.size () );
+
+    for ( auto const sample : samples_ )
+        writeWord ( out, sample );
+
+    if ( !out.flush () )
+        return fail ( "Unable to write '" + sidecarPath + "'." );
+
+    return true;
+}
+
+bool
+SidecarIndex::open ( std::string const& path, std::string const& sidecarPath )
+{
+    errors_.clear ();
+    path_ = path;
+    count_ = 0;
+    samples_.clear ();
+
+    boost::system::error_code ec;
+    std::uint64_t const sidecarSize =
+        boost::filesystem::file_size ( sidecarPath, ec );
+    std::ifstream in ( sidecarPath, std::ios::binary );
+    char header[sizeof ( magic )];
+
+    if ( !in.read ( header, sizeof ( header ) )  ||
+            !std::equal ( header, header + sizeof ( header ), magic ) )
+        return fail ( "'" + sidecarPath + "' is not a sidecar index." );
+
+    Signature recorded;
+    std::uint64_t sampleEvery;
+    std::uint64_t count;
+    std::uint64_t samples;
+
+    // The header is the magic and six words, and the samples fill the rest
+    // of the sidecar exactly. Checking the count against the sidecar's size
+    // before allocating keeps a corrupt count from exhausting memory.
+    std::uint64_t const headerSize = sizeof ( magic ) + 6 * 8;
+
+    if ( ec  ||  !readWord ( in, recorded.size )  ||
+            !readWord ( in, recorded.modified )  ||
+            !readWord ( in, recorded.hash )  ||
+            !readWord ( in, sampleEvery )  ||
+            !readWord ( in, count )  ||
+            !readWord ( in, samples )  ||
+            sampleEvery == 0  ||
+            samples != count / sampleEvery + ( count % sampleEvery != 0 )  ||
+            samples != ( sidecarSize - headerSize ) / 8  ||
+            ( sidecarSize - headerSize ) % 8 != 0 )
+        return fail ( "'" + sidecarPath + "' is corrupt." );
+
+    Signature current;
+
+    if ( !sign ( path, current ) )
+        return false;
+
+    if ( current.size != recorded.size  ||
+            current.modified != recorded.modified  ||
+            current.hash != recorded.hash )
+        return fail ( "'" + sidecarPath + "' is out of date." );
+
+    // Every element takes at least one byte of the file, after the '['.
+    if ( count >= current.size )
+        return fail ( "'" + sidecarPath + "' is corrupt." );
+
+    std::vector<std::uint64_t> offsets ( samples );
+    std::uint64_t previous = 0;
+
+    for ( auto& offset : offsets )
+    {
+        if ( !readWord ( in, offset )  ||  offset <= previous  ||
+                offset >= current.size )
+            return fail ( "'" + sidecarPath + "' is corrupt." );
+
+        previous = offset;
+    }
+
+    signature_ = current;
+    sampleEvery_ = sampleEvery;
+    count_ = count;
+    samples_ = std::move ( offsets );
+    return true;
+}
+
+bool
+SidecarIndex::element ( std::size_t i, Value& value )
+{
+    errors_.clear ();
+
+    if ( i >= count_ )
+        return fail ( "Element " + std::to_string ( i ) + " is out of range." );
+
+    std::ifstream in ( path_, std::ios::binary );
+
+    if ( !in.seekg ( samples_[i / sampleEvery_] ) )
+        return fail ( "Unable to read '" + path_ + "'." );
+
+    // Skip from the sample to the requested element, then capture it.
+    ArrayScanner scanner;
+    scanner.atElement ();
+    std::size_t index = i - i % sampleEvery_;
+    bool first = true;
+    bool capturing = false;
+    bool complete = false;
+    std::string text;
+    std::vector<char> buffer ( 64 * 1024 );
+
+    while ( !complete  &&  in )
+    {
+        in.read ( buffer.data (), buffer.size () );
+        std::size_t const got = static_cast<std::size_t> ( in.gcount () );
+
+        for ( std::size_t j = 0; j < got  &&  !complete; ++j )
+        {
+            auto const event = scanner.feed ( buffer[j] );
+
+            if ( event == ArrayScanner::bad )
+                return fail ( "'" + path_ + "' has changed since it was indexed." );
+
+            if ( event == ArrayScanner::elementBegin )
+            {
+                if ( !first )
+                    ++index;
+
+                first = false;
+                capturing = ( index == i );
+            }
+
+            if ( capturing )
+            {
+                if ( event == ArrayScanner::elementEnd  ||
+                        event == ArrayScanner::arrayEnd )
+                    complete = true;
+                else
+                    text += buffer[j];
+            }
+            else if ( event == ArrayScanner::arrayEnd )
+            {
+                return fail ( "'" + path_ + "' has changed since it was indexed." );
+            }
+        }
+    }
+
+    if ( !complete )
+        return fail ( "'" + path_ + "' has changed since it was indexed." );
+
+    Reader reader;
+
+    if ( !reader.parseValue ( text.data (), text.data () + text.size (), value ) )
+        return fail ( "In element " + std::to_string ( i ) + ":\n" +
+            reader.getFormatedErrorMessages () );
+
+    return true;
+}
+
+std::string
+SidecarIndex::getFormatedErrorMessages () const
+{
+    return errors_;
+}
+
+bool
+SidecarIndex::sign ( std::string const& path, Signature& signature )
+{
+    namespace fs = boost::filesystem;
+
+    boost::system::error_code ec;
+    signature.size = fs::file_size ( path, ec );
+
+    if ( !ec )
+        signature.modified = static_cast<std::uint64_t> (
+            fs::last_write_time ( path, ec ) );
+
+    std::ifstream in ( path, std::ios::binary );
+
+    if ( ec  ||  !in )
+        return fail ( "Unable to read '" + path + "'." );
+
+    // Hash the head and the tail of the file.
+    std::vector<char> buffer ( signatureSpan );
+    signature.hash = 0xcbf29ce484222325ull;
+
+    in.read ( buffer.data (), buffer.size () );
+    hashBytes ( signature.hash, buffer.data (),
+        static_cast<std::size_t> ( in.gcount () ) );
+
+    if ( signature.size > signatureSpan )
+    {
+        in.clear ();
+        in.seekg ( signature.size - signatureSpan );
+        in.read ( buffer.data (), buffer.size () );
+        hashBytes ( signature.hash, buffer.data (),
+            static_cast<std::size_t> ( in.gcount () ) );
+    }
+
+    return true;
+}
+
+bool
+SidecarIndex::fail ( std::string const& message )
+{
+    errors_ = message + "\n";
+    return false;
+}
+
+} // namespace Json
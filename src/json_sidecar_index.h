@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_SIDECAR_INDEX_H_INCLUDED
+#define RIPPLE_JSON_JSON_SIDECAR_INDEX_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Json
+{
+
+/** \brief Random access to the elements of a large JSON array file.
+
+    Building the index scans a file whose root is an array once, with
+    constant memory, and records the offset of every k'th element in a
+    sidecar file. Later, element i is found by seeking to the sample before
+    it and skipping at most k - 1 elements, and only that element is
+    parsed, so repeated lookups into a multi-gigabyte export cost a few
+    kilobytes of I/O each.
+
+    The sidecar records the size, modification time and a hash of the head
+    and tail of the file it describes, and open() rejects a sidecar that no
+    longer matches. This is a cheap check, not a guarantee: only the first
+    and last 64 KiB are hashed and modification times have a resolution of
+    one second, so an edit that keeps the size and touches only the middle
+    of the file within the second it was indexed, or that restores the
+    modification time, goes unnoticed. Such a file is read through the
+    stale index, and element() may then fail or return the wrong element.
+    Rebuild the index after editing a file in place.
+
+    Files containing comments are not indexed.
+*/
+class SidecarIndex
+{
+public:
+    SidecarIndex ();
+
+    /** \brief Index the array file at \a path and write the sidecar.
+     * \param sidecarPath Where to write the index.
+     * \param sampleEvery Record the offset of every this many elements.
+     * \return \c true if the file was indexed and the sidecar written.
+     */
+    bool build ( std::string const& path, std::string const& sidecarPath,
+                 std::size_t sampleEvery = 1024 );
+
+    /** \brief Load the sidecar for the file at \a path.
+     * \return \c true if the sidecar was read and still matches the file,
+     *         \c false if it is missing, corrupt or stale.
+     */
+    bool open ( std::string const& path, std::string const& sidecarPath );
+
+    /// \brief Number of elements in the indexed array.
+    std::size_t size () const
+    {
+        return count_;
+    }
+
+    /** \brief Read and parse element \a i of the indexed array.
+     * \return \c true if the element was read and parsed.
+     */
+    bool element ( std::size_t i, Value& value );
+
+    /** \brief Returns a user friendly string describing the last error, or
+     *         an empty string.
+     */
+    std::string getFormatedErrorMessages () const;
+
+private:
+    struct Signature
+    {
+        std::uint64_t size;
+        std::uint64_t modified;
+        std::uint64_t hash;
+    };
+
+    bool sign ( std::string const& path, Signature& signature );
+    bool fail ( std::string const& message );
+
+    std::string path_;
+    Signature signature_;
+    std::size_t sampleEvery_;
+    std::size_t count_;
+    std::vector<std::uint64_t> samples_;
+    std::string errors_;
+};
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,85 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+
+#ifndef RIPPLE_JSON_JSON_STRING_POOL_H_INCLUDED
+#define RIPPLE_JSON_JSON_STRING_POOL_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <cstddef>
+#include <string>
+#include <unordered_set>
+
+namespace Json
+{
+
+/** \brief Shared, immutable storage for repeated strings.
+
+    Documents repeat the same strings heavily: account addresses, currency
+    codes, transaction type names, ledger hashes. When a Reader is given a
+    StringPool, every string value it decodes is stored once in the pool
+    and the Value refers to that copy as a StaticString instead of
+    allocating its own.
+
+    The pool must outlive every Value built with it. Copying such a Value
+    gives the copy its own string, as for any StaticString. A pool may be
+    kept across several parses to share strings over a whole batch, but it
+    is not safe to use from several threads at once.
+*/
+class StringPool
+{
+public:
+    StringPool ()
+        : bytesSaved_ (0)
+    {
+    }
+
+    StringPool ( StringPool const& ) = delete;
+    StringPool& operator= ( StringPool const& ) = delete;
+
+    /** \brief Return the pooled copy of \a s, adding it if necessary.
+     * \a s must not contain a NUL character.
+     */
+    StaticString intern ( std::string const& s );
+
+    /// \brief Number of distinct strings held.
+    std::size_t size () const
+    {
+        return strings_.size ();
+    }
+
+    /// \brief Bytes that interned duplicates would otherwise have allocated.
+    std::size_t bytesSaved () const
+    {
+        return bytesSaved_;
+    }
+
+    /** \brief Release every string.
+     * No Value built with the pool may be used afterwards.
+     */
+    void clear ();
+
+private:
+    std::unordered_set<std::string> strings_;
+    std::size_t bytesSaved_;
+};
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_struct_reader.h>
+
+namespace Json
+{
+
+StructReader::StructReader ()
+    : depth_ (0)
+{
+}
+
+std::string
+StructReader::getFormatedErrorMessages () const
+{
+    return reader_.getFormatedErrorMessages ();
+}
+
+void
+StructReader::start ( const char* beginDoc, const char* endDoc )
+{
+    reader_.begin_ = beginDoc;
+    reader_.end_ = endDoc;
+    reader_.current_ = beginDoc;
+    reader_.lastValueEnd_ = 0;
+    reader_.lastValue_ = 0;
+    reader_.abandonArray ();
+    reader_.errors_.clear ();
+    reader_.hashes_.clear ();
+    reader_.memberIndexes_.clear ();
+
+    while ( !reader_.nodes_.empty () )
+        reader_.nodes_.pop ();
+
+    depth_ = 0;
+    reader_.probeParseBegin ( beginDoc, endDoc );
+}
+
+bool
+StructReader::finish ( bool fits )
+{
+    if ( fits )
+    {
+        Reader::Token token;
+        reader_.skipCommentTokens ( token );
+        fits = token.type_ == Reader::tokenEndOfStream;
+    }
+
+    reader_.probeParseEnd ( reader_.begin_, reader_.end_, fits );
+    return fits;
+}
+
+bool
+StructReader::read ( bool& value )
+{
+    Reader::Token token;
+    reader_.skipCommentTokens ( token );
+
+    if ( token.type_ != Reader::tokenTrue  &&
+            token.type_ != Reader::tokenFalse )
+        return false;
+
+    value = token.type_ == Reader::tokenTrue;
+    return true;
+}
+
+bool
+StructReader::read ( int& value )
+{
+    Reader::Token token;
+    Value number;
+    reader_.skipCommentTokens ( token );
+
+    if ( token.type_ != Reader::tokenInteger  ||
+            !scalar ( token, number )  ||  number.type () != intValue )
+        return false;
+
+    value = number.asInt ();
+    return true;
+}
+
+bool
+StructReader::read ( unsigned& value )
+{
+    Reader::Token token;
+    Value number;
+    reader_.skipCommentTokens ( token );
+
+    if ( token.type_ != Reader::tokenInteger  ||
+            !scalar ( token, number ) )
+        return false;
+
+    if ( number.type () == intValue  &&  number.asInt () < 0 )
+        return false;
+
+    value = number.asUInt ();
+    return true;
+}
+
+bool
+StructReader::read ( double& value )
+{
+    Reader::Token token;
+    Value number;
+    reader_.skipCommentTokens ( token );
+
+    if ( ( token.type_ != Reader::tokenInteger  &&
+            token.type_ != Reader::tokenDouble )  ||
+            !scalar ( token, number ) )
+        return false;
+
+    value = number.asDouble ();
+    return true;
+}
+
+bool
+StructReader::read ( std::string& value )
+{
+    Reader::Token token;
+    reader_.skipCommentTokens ( token );
+
+    if ( token.type_ != Reader::tokenString )
+        return false;
+
+    value.clear ();
+    return reader_.decodeString ( token, value );
+}
+
+bool
+StructReader::read ( Value& value )
+{
+    reader_.nodes_.push ( &value );
+    bool ok = reader_.readValue ( depth_ );
+    reader_.nodes_.pop ();
+    return ok;
+}
+
+bool
+StructReader::enter ( Reader::TokenType type, bool& empty )
+{
+    Reader::Token token;
+    reader_.skipCommentTokens ( token );
+
+    if ( token.type_ != type  ||  depth_ > Reader::nest_limit )
+        return false;
+
+    ++depth_;
+
+    // Look ahead for an immediate close, as Reader::nextElement does.
+    reader_.skipSpaces ();
+    char const close = ( type == Reader::tokenObjectBegin ) ? '}' : ']';
+    empty = reader_.current_ != reader_.end_  &&  *reader_.current_ == close;
+
+    if ( empty )
+    {
+        reader_.readToken ( token );
+        --depth_;
+    }
+
+    return true;
+}
+
+bool
+StructReader::memberName ( std::string& name )
+{
+    Reader::Token token;
+    reader_.skipCommentTokens ( token );
+
+    if ( token.type_ != Reader::tokenString )
+        return false;
+
+    name.clear ();
+
+    if ( !reader_.decodeString ( token, name ) )
+        return false;
+
+    reader_.skipCommentTokens ( token );
+    return token.type_ == Reader::tokenMemberSeparator;
+}
+
+bool
+StructReader::next ( Reader::TokenType end, bool& more )
+{
+    Reader::Token token;
+    reader_.skipCommentTokens ( token );
+
+    if ( token.type_ == end )
+    {
+        more = false;
+        --depth_;
+        return true;
+    }
+
+    more = true;
+    return token.type_ == Reader::tokenArraySeparator;
+}
+
+bool
+StructReader::scalar ( Reader::Token& token, Value& value )
+{
+    reader_.nodes_.push ( &value );
+    bool ok = ( token.type_ == Reader::tokenInteger ) ?
+        reader_.decodeNumber ( token ) : reader_.decodeDouble ( token );
+    reader_.nodes_.pop ();
+    return ok;
+}
+
+} // namespace Json
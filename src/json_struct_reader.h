@@ -0,0 +1,199 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_STRUCT_READER_H_INCLUDED
+#define RIPPLE_JSON_JSON_STRUCT_READER_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <json_binding.h>
+#include <json_reader.h>
+#include <string>
+#include <vector>
+
+namespace Json
+{
+
+/** \brief Read JSON documents straight into bound structs.
+
+    The struct types are described by Binding field tables, written by hand
+    or generated by Schema::generate(). Reading follows the field tables
+    with Reader's own tokenizer, validating each member as it arrives and
+    storing it in place, so no Value is built for the document.
+
+    When the document does not fit the struct - an unexpected or missing
+    member, or a value of another type - it is read again with the generic
+    Reader instead, so deviating input is still accepted, and malformed
+    input is reported exactly as Reader reports it.
+
+    Members may be bool, int, unsigned, double, std::string, Value,
+    std::vector of any of these, or another bound struct.
+*/
+class StructReader
+{
+public:
+    /// \brief How a document was read.
+    enum Outcome
+    {
+        bound,      ///< The document was read into the struct
+        generic,    ///< The document did not fit, and was read into a Value
+        failed      ///< The document is not valid JSON
+    };
+
+    StructReader ();
+
+    /** \brief Read a document into \a object, or into \a fallback if it
+     *         does not fit.
+     *
+     * Unless the outcome is \c bound, \a object may have been partly
+     * assigned and should be discarded.
+     */
+    template <class T>
+    Outcome parse ( const char* beginDoc, const char* endDoc,
+                    T& object, Value& fallback );
+
+    template <class T>
+    Outcome parse ( std::string const& document, T& object, Value& fallback )
+    {
+        return parse ( document.data (), document.data () + document.size (),
+                       object, fallback );
+    }
+
+    /** \brief Returns a user friendly string that list errors in the parsed
+     *         document, when the outcome was \c failed.
+     */
+    std::string getFormatedErrorMessages () const;
+
+private:
+    // Bracket a bound read, as Reader::parse() brackets its own.
+    void start ( const char* beginDoc, const char* endDoc );
+    bool finish ( bool fits );
+
+    bool read ( bool& value );
+    bool read ( int& value );
+    bool read ( unsigned& value );
+    bool read ( double& value );
+    bool read ( std::string& value );
+    bool read ( Value& value );
+
+    template <class T>
+    bool read ( std::vector<T>& elements );
+
+    template <class T>
+    typename std::enable_if<isBound<T>::value, bool>::type
+    read ( T& object );
+
+    bool enter ( Reader::TokenType type, bool& empty );
+    bool memberName ( std::string& name );
+    bool next ( Reader::TokenType end, bool& more );
+    bool scalar ( Reader::Token& token, Value& value );
+
+    Reader reader_;
+    unsigned depth_;
+    std::string name_;
+};
+
+template <class T>
+StructReader::Outcome
+StructReader::parse ( const char* beginDoc, const char* endDoc,
+                      T& object, Value& fallback )
+{
+    start ( beginDoc, endDoc );
+
+    if ( finish ( read ( object ) ) )
+        return bound;
+
+    if ( reader_.parse ( beginDoc, endDoc, fallback ) )
+        return generic;
+
+    return failed;
+}
+
+template <class T>
+bool
+StructReader::read ( std::vector<T>& elements )
+{
+    elements.clear ();
+    bool more;
+
+    if ( !enter ( Reader::tokenArrayBegin, more ) )
+        return false;
+
+    more = !more;
+
+    while ( more )
+    {
+        elements.emplace_back ();
+
+        if ( !read ( elements.back () )  ||
+                !next ( Reader::tokenArrayEnd, more ) )
+            return false;
+    }
+
+    return true;
+}
+
+template <class T>
+typename std::enable_if<isBound<T>::value, bool>::type
+StructReader::read ( T& object )
+{
+    bool seen[fieldCount<T> () + 1] = {};
+    bool more;
+
+    if ( !enter ( Reader::tokenObjectBegin, more ) )
+        return false;
+
+    more = !more;
+
+    while ( more )
+    {
+        if ( !memberName ( name_ ) )
+            return false;
+
+        bool known = false;
+        bool ok = true;
+
+        forEachField<T> ( [&] ( auto const& f, std::size_t i )
+        {
+            if ( !known  &&  name_ == f.name )
+            {
+                // Reader rejects repeated members, so let it report them.
+                known = true;
+                ok = !seen[i]  &&  read ( object.*f.member );
+                seen[i] = true;
+            }
+        } );
+
+        if ( !known  ||  !ok  ||  !next ( Reader::tokenObjectEnd, more ) )
+            return false;
+    }
+
+    bool complete = true;
+
+    forEachField<T> ( [&] ( auto const& f, std::size_t i )
+    {
+        if ( !seen[i]  &&  !f.optional )
+            complete = false;
+    } );
+
+    return complete;
+}
+
+} // namespace Json
+
+#endif
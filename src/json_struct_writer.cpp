@@ -0,0 +1,223 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_struct_writer.h>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace Json
+{
+
+void
+StructWriter::append ( bool value )
+{
+    out_ += value ? "true" : "false";
+}
+
+void
+StructWriter::append ( int value )
+{
+    if ( value < 0 )
+    {
+        out_ += '-';
+        // Negate in unsigned arithmetic so the minimum value is exact.
+        append ( 0u - static_cast<unsigned> ( value ) );
+    }
+    else
+    {
+        append ( static_cast<unsigned> ( value ) );
+    }
+}
+
+void
+StructWriter::append ( unsigned value )
+{
+    char digits[16];
+    char* p = digits + sizeof ( digits );
+
+    do
+    {
+        *--p = static_cast<char> ( '0' + value % 10 );
+        value /= 10;
+    }
+    while ( value != 0 );
+
+    out_.append ( p, digits + sizeof ( digits ) );
+}
+
+void
+StructWriter::append ( double value )
+{
+    if ( !std::isfinite ( value ) )
+    {
+        out_ += "null";
+        return;
+    }
+
+    char buffer[32];
+    int const length = std::snprintf ( buffer, sizeof ( buffer ), "%.17g", value );
+    bool real = false;
+    bool point = false;
+
+    // The decimal point follows LC_NUMERIC and may be ',' or even several
+    // bytes. Everything other than digits, signs and the exponent is the
+    // point, and is written as '.'.
+    for ( int i = 0; i < length; ++i )
+    {
+        char const c = buffer[i];
+
+        if ( ( c >= '0'  &&  c <= '9' )  ||  c == '-'  ||  c == '+' )
+        {
+            out_ += c;
+            point = false;
+        }
+        else if ( c == 'e' )
+        {
+            out_ += c;
+            real = true;
+            point = false;
+        }
+        else if ( !point )
+        {
+            out_ += '.';
+            real = true;
+            point = true;
+        }
+    }
+
+    // Keep integral values real, since Reader rejects integers outside
+    // the 32-bit range.
+    if ( !real )
+        out_ += ".0";
+}
+
+void
+StructWriter::append ( std::string const& value )
+{
+    appendString ( value.data (), value.size () );
+}
+
+void
+StructWriter::append ( Value const& value )
+{
+    switch ( value.type () )
+    {
+    case nullValue:
+        out_ += "null";
+        break;
+
+    case intValue:
+        append ( static_cast<int> ( value.asInt () ) );
+        break;
+
+    case uintValue:
+        append ( static_cast<unsigned> ( value.asUInt () ) );
+        break;
+
+    case realValue:
+        append ( value.asDouble () );
+        break;
+
+    case stringValue:
+        append ( value.asString () );
+        break;
+
+    case booleanValue:
+        append ( value.asBool () );
+        break;
+
+    case arrayValue:
+        out_ += '[';
+
+        for ( Value::UInt i = 0; i < value.size (); ++i )
+        {
+            if ( i != 0 )
+                out_ += ',';
+
+            append ( value[i] );
+        }
+
+        out_ += ']';
+        break;
+
+    case objectValue:
+        out_ += '{';
+
+        for ( auto it = value.begin (); it != value.end (); ++it )
+        {
+            if ( it != value.begin () )
+                out_ += ',';
+
+            const char* name = it.memberName ();
+            appendString ( name, std::strlen ( name ) );
+            out_ += ':';
+            append ( *it );
+        }
+
+        out_ += '}';
+        break;
+    }
+}
+
+void
+StructWriter::appendString ( const char* data, std::size_t size )
+{
+    static char const hex[] = "0123456789abcdef";
+
+    out_ += '"';
+
+    // Copy runs of characters that need no escaping in one go.
+    const char* run = data;
+    const char* const end = data + size;
+
+    for ( const char* p = data; p != end; ++p )
+    {
+        unsigned char const c = static_cast<unsigned char> ( *p );
+
+        if ( c >= 0x20  &&  c != '"'  &&  c != '\\' )
+            continue;
+
+        out_.append ( run, p );
+        run = p + 1;
+
+        switch ( c )
+        {
+        case '"':  out_ += "\\\""; break;
+        case '\\': out_ += "\\\\"; break;
+        case '\b': out_ += "\\b"; break;
+        case '\f': out_ += "\\f"; break;
+        case '\n': out_ += "\\n"; break;
+        case '\r': out_ += "\\r"; break;
+        case '\t': out_ += "\\t"; break;
+
+        default:
+            out_ += "\\u00";
+            out_ += hex[c >> 4];
+            out_ += hex[c & 0xf];
+            break;
+        }
+    }
+
+    out_.append ( run, end );
+    out_ += '"';
+}
+
+} // namespace Json
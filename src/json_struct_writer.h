@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_STRUCT_WRITER_H_INCLUDED
+#define RIPPLE_JSON_JSON_STRUCT_WRITER_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <json_binding.h>
+#include <string>
+#include <vector>
+
+namespace Json
+{
+
+/** \brief Write bound structs directly as JSON text.
+
+    The inverse of StructReader. Members are written in the order of the
+    struct's Binding field table, which is unrolled at compile time, into
+    a buffer the writer reuses, so no Value is built for the document and,
+    once the buffer has grown, no memory is allocated. Reader and writer
+    share the one field table, so the two cannot disagree on a schema.
+
+    Output is compact. Optional members are always written. Numbers that
+    are not finite have no JSON form and are written as null.
+*/
+class StructWriter
+{
+public:
+    /** \brief Serialize \a object.
+     * \return The text, valid until the next call.
+     */
+    template <class T>
+    std::string const& write ( T const& object )
+    {
+        out_.clear ();
+        append ( object );
+        return out_;
+    }
+
+private:
+    void append ( bool value );
+    void append ( int value );
+    void append ( unsigned value );
+    void append ( double value );
+    void append ( std::string const& value );
+    void append ( Value const& value );
+
+    template <class T>
+    void append ( std::vector<T> const& elements );
+
+    template <class T>
+    typename std::enable_if<isBound<T>::value>::type
+    append ( T const& object );
+
+    void appendString ( const char* data, std::size_t size );
+
+    std::string out_;
+};
+
+template <class T>
+void
+StructWriter::append ( std::vector<T> const& elements )
+{
+    out_ += '[';
+
+    for ( std::size_t i = 0; i < elements.size (); ++i )
+    {
+        if ( i != 0 )
+            out_ += ',';
+
+        append ( static_cast<T const&> ( elements[i] ) );
+    }
+
+    out_ += ']';
+}
+
+template <class T>
+typename std::enable_if<isBound<T>::value>::type
+StructWriter::append ( T const& object )
+{
+    out_ += '{';
+
+    forEachField<T> ( [&] ( auto const& f, std::size_t i )
+    {
+        if ( i != 0 )
+            out_ += ',';
+
+        appendString ( f.name, std::char_traits<char>::length ( f.name ) );
+        out_ += ':';
+        append ( object.*f.member );
+    } );
+
+    out_ += '}';
+}
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,158 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_structural_index.h>
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+namespace Json
+{
+
+namespace {
+
+// Below this many bytes per thread, starting threads costs more than the
+// scan itself.
+std::size_t const minChunkSize = 1024 * 1024;
+
+// The structural characters of one chunk, under both assumptions about
+// whether the chunk starts inside a string.
+struct Chunk
+{
+    const char* begin;
+    const char* end;
+    // Entries assuming the chunk starts outside (0) or inside (1) a string.
+    StructuralIndex::Offsets found[2];
+    // Whether the chunk holds an odd number of unescaped quotes.
+    bool flipsString = false;
+};
+
+bool
+isStructural ( char c )
+{
+    switch ( c )
+    {
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case ':':
+    case ',':
+    case '/':
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+void
+scanChunk ( const char* beginDoc, Chunk& chunk )
+{
+    // A backslash escapes the character after it, so the first character
+    // of the chunk is escaped if an odd run of backslashes precedes it.
+    bool escaped = false;
+
+    for ( const char* p = chunk.begin; p != beginDoc  &&  p[-1] == '\\'; --p )
+        escaped = !escaped;
+
+    bool inString = false;
+
+    for ( const char* p = chunk.begin; p != chunk.end; ++p )
+    {
+        char const c = *p;
+
+        if ( escaped )
+            escaped = false;
+        else if ( c == '\\' )
+            escaped = true;
+        else if ( c == '"' )
+            inString = !inString;
+        else if ( isStructural ( c ) )
+            chunk.found[inString].push_back ( p - beginDoc );
+    }
+
+    chunk.flipsString = inString;
+}
+
+} // namespace
+
+StructuralIndex::StructuralIndex ( const char* beginDoc, const char* endDoc,
+                                   unsigned threads )
+{
+    std::size_t const size = endDoc - beginDoc;
+
+    if ( threads < 1 )
+        threads = 1;
+
+    if ( size / threads < minChunkSize )
+        threads = std::max<std::size_t> ( size / minChunkSize, 1 );
+
+    std::vector<Chunk> chunks ( threads );
+    std::size_t const chunkSize = size / threads;
+
+    for ( unsigned i = 0; i < threads; ++i )
+    {
+        chunks[i].begin = beginDoc + i * chunkSize;
+        chunks[i].end = ( i + 1 == threads ) ? endDoc :
+            chunks[i].begin + chunkSize;
+    }
+
+    if ( threads == 1 )
+    {
+        scanChunk ( beginDoc, chunks[0] );
+    }
+    else
+    {
+        std::vector<std::thread> workers;
+        workers.reserve ( threads - 1 );
+
+        for ( unsigned i = 1; i < threads; ++i )
+            workers.emplace_back ( scanChunk, beginDoc, std::ref ( chunks[i] ) );
+
+        scanChunk ( beginDoc, chunks[0] );
+
+        for ( auto& worker : workers )
+            worker.join ();
+    }
+
+    // Stitch the chunks together: whether a chunk starts inside a string
+    // is the parity of the quotes in every chunk before it.
+    bool inString = false;
+    std::size_t total = 0;
+
+    for ( auto const& chunk : chunks )
+    {
+        total += chunk.found[inString].size ();
+        inString ^= chunk.flipsString;
+    }
+
+    offsets_.reserve ( total );
+    inString = false;
+
+    for ( auto& chunk : chunks )
+    {
+        auto const& found = chunk.found[inString];
+        offsets_.insert ( offsets_.end (), found.begin (), found.end () );
+        inString ^= chunk.flipsString;
+    }
+}
+
+} // namespace Json
@@ -0,0 +1,91 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_STRUCTURAL_INDEX_H_INCLUDED
+#define RIPPLE_JSON_JSON_STRUCTURAL_INDEX_H_INCLUDED
+
+#include <cstddef>
+#include <vector>
+
+namespace Json
+{
+
+/** \brief Offsets of the structural characters of a JSON document.
+
+    The index lists, in document order, the offset of every '{', '}', '[',
+    ']', ':' and ',' that lies outside a string. It does not validate the
+    document; Reader does that when the values are built.
+
+    Comments are not understood, so every '/' outside a string is listed
+    too. Entries after the first '/' may be wrong, and callers should fall
+    back to Reader for documents that contain one.
+
+    Large documents can be indexed on several threads. The input is split
+    into chunks which are scanned concurrently under both assumptions about
+    whether the chunk starts inside a string; a prefix pass over the quote
+    parity of each chunk then selects the right result. The merged index is
+    identical to the one a sequential scan produces.
+*/
+class StructuralIndex
+{
+public:
+    using Offsets = std::vector<std::size_t>;
+    using const_iterator = Offsets::const_iterator;
+
+    /** \brief Index the document [beginDoc, endDoc).
+     * \param threads Number of threads to scan with. Documents too small
+     *        to benefit are always scanned sequentially.
+     */
+    StructuralIndex ( const char* beginDoc, const char* endDoc,
+                      unsigned threads = 1 );
+
+    /// \brief Number of structural characters in the document.
+    std::size_t size () const
+    {
+        return offsets_.size ();
+    }
+
+    /// \brief Offset from the start of the document of the i'th entry.
+    std::size_t operator[] ( std::size_t i ) const
+    {
+        return offsets_[i];
+    }
+
+    const_iterator begin () const
+    {
+        return offsets_.begin ();
+    }
+
+    const_iterator end () const
+    {
+        return offsets_.end ();
+    }
+
+    Offsets const& offsets () const
+    {
+        return offsets_;
+    }
+
+private:
+    Offsets offsets_;
+};
+
+} // namespace Json
+
+#endif
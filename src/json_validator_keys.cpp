@@ -0,0 +1,898 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_validator_keys.h>
+#include <json_base58.h>
+#include <json_base64.h>
+#include <json_reader.h>
+#include <json_serialized_writer.h>
+#include <openssl/bn.h>
+#include <openssl/core_names.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/obj_mac.h>
+#include <openssl/param_build.h>
+#include <openssl/rand.h>
+#include <openssl/sha.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+namespace Json
+{
+
+namespace {
+
+// Key pairs generated by each call to KeyGenerator::generateCandidates
+// while searching.
+std::size_t const batchSize = 256;
+
+// The order of the secp256k1 group and its half, above which signatures
+// are not canonical.
+struct Order
+{
+    BIGNUM* order = nullptr;
+    BIGNUM* half = nullptr;
+
+    Order ()
+    {
+        BN_hex2bn ( &order,
+            "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141" );
+        half = BN_dup ( order );
+        BN_rshift1 ( half, half );
+    }
+
+    ~Order ()
+    {
+        BN_free ( half );
+        BN_free ( order );
+    }
+};
+
+Order const&
+secp256k1Order ()
+{
+    static Order const order;
+    return order;
+}
+
+// Build an OpenSSL secp256k1 key from its compressed public key and,
+// for signing, its secret key.
+EVP_PKEY*
+secp256k1Key ( std::uint8_t const* publicKey, std::uint8_t const* secret )
+{
+    OSSL_PARAM_BLD* builder = OSSL_PARAM_BLD_new ();
+    EVP_PKEY_CTX* context =
+        EVP_PKEY_CTX_new_from_name ( nullptr, "EC", nullptr );
+    BIGNUM* scalar = secret ? BN_bin2bn ( secret, 32, nullptr ) : nullptr;
+    OSSL_PARAM* params = nullptr;
+    EVP_PKEY* key = nullptr;
+
+    if ( builder  &&  context
+        &&  OSSL_PARAM_BLD_push_utf8_string ( builder,
+                OSSL_PKEY_PARAM_GROUP_NAME, "secp256k1", 0 )
+        &&  OSSL_PARAM_BLD_push_octet_string ( builder,
+                OSSL_PKEY_PARAM_PUB_KEY, publicKey, 33 )
+        &&  ( !secret  ||  ( scalar  &&  OSSL_PARAM_BLD_push_BN ( builder,
+                OSSL_PKEY_PARAM_PRIV_KEY, scalar ) ) )
+        &&  ( params = OSSL_PARAM_BLD_to_param ( builder ) )
+        &&  EVP_PKEY_fromdata_init ( context ) == 1 )
+        EVP_PKEY_fromdata ( context, &key,
+            secret ? EVP_PKEY_KEYPAIR : EVP_PKEY_PUBLIC_KEY, params );
+
+    OSSL_PARAM_free ( params );
+    BN_clear_free ( scalar );
+    EVP_PKEY_CTX_free ( context );
+    OSSL_PARAM_BLD_free ( builder );
+    return key;
+}
+
+// The first half of the SHA-512 of a message, which secp256k1 keys sign.
+void
+sha512Half ( std::string const& message, std::uint8_t* out )
+{
+    std::uint8_t digest[SHA512_DIGEST_LENGTH];
+    SHA512 ( reinterpret_cast<std::uint8_t const*> ( message.data () ),
+        message.size (), digest );
+    std::memcpy ( out, digest, 32 );
+}
+
+char const hexDigits[] = "0123456789ABCDEF";
+
+std::string
+toHex ( std::uint8_t const* bytes, std::size_t size )
+{
+    std::string hex;
+    hex.reserve ( 2 * size );
+
+    for ( std::size_t i = 0; i < size; ++i )
+    {
+        hex += hexDigits[bytes[i] >> 4];
+        hex += hexDigits[bytes[i] & 0x0f];
+    }
+
+    return hex;
+}
+
+bool
+fromHex ( std::string const& hex, std::string& bytes )
+{
+    auto digit = [] ( char c )
+    {
+        if ( c >= '0'  &&  c <= '9' )
+            return c - '0';
+
+        if ( c >= 'A'  &&  c <= 'F' )
+            return c - 'A' + 10;
+
+        if ( c >= 'a'  &&  c <= 'f' )
+            return c - 'a' + 10;
+
+        return -1;
+    };
+
+    if ( hex.size () % 2 != 0 )
+        return false;
+
+    bytes.clear ();
+
+    for ( std::size_t i = 0; i < hex.size (); i += 2 )
+    {
+        int const high = digit ( hex[i] );
+        int const low = digit ( hex[i + 1] );
+
+        if ( high < 0  ||  low < 0 )
+            return false;
+
+        bytes += static_cast<char> ( high * 16 + low );
+    }
+
+    return true;
+}
+
+// The manifest fields that are signed, in canonical order: Sequence,
+// PublicKey and SigningPubKey.
+std::string
+manifestFields ( std::array<std::uint8_t, 33> const& master,
+                 std::array<std::uint8_t, 33> const& signing,
+                 std::uint32_t sequence )
+{
+    std::string fields;
+    fields += '\x24';
+
+    for ( int shift = 24; shift >= 0; shift -= 8 )
+        fields += static_cast<char> ( sequence >> shift );
+
+    fields += '\x71';
+    fields += static_cast<char> ( master.size () );
+    fields.append ( master.begin (), master.end () );
+    fields += '\x73';
+    fields += static_cast<char> ( signing.size () );
+    fields.append ( signing.begin (), signing.end () );
+    return fields;
+}
+
+// Manifests are signed with the hash prefix "MAN\0".
+std::string
+manifestMessage ( std::string const& fields )
+{
+    return std::string ( "MAN\0", 4 ) + fields;
+}
+
+void
+randomBytes ( std::uint8_t* out, std::size_t size )
+{
+    // OpenSSL keeps a private DRBG per thread, so threads drawing secrets
+    // concurrently do not contend on a lock.
+    if ( RAND_priv_bytes ( out, static_cast<int> ( size ) ) != 1 )
+        throw std::runtime_error ( "random number generator failed" );
+}
+
+} // namespace
+
+//------------------------------------------------------------------------------
+
+std::string
+ValidatorKeys::publicKeyText () const
+{
+    std::string text;
+    base58CheckEncode ( tokenNodePublic, publicKey.data (),
+        publicKey.size (), text );
+    return text;
+}
+
+std::string
+ValidatorKeys::secretKeyText () const
+{
+    std::string text;
+    base58CheckEncode ( tokenNodePrivate, secretKey.data (),
+        secretKey.size (), text );
+    return text;
+}
+
+Value
+ValidatorKeys::toJson () const
+{
+    Value file ( objectValue );
+    file["key_type"] = keyType == KeyType::ed25519 ? "ed25519" : "secp256k1";
+    file["public_key"] = publicKeyText ();
+    file["revoked"] = false;
+    file["secret_key"] = secretKeyText ();
+    file["token_sequence"] = Value::UInt ( tokenSequence );
+    return file;
+}
+
+bool
+ValidatorKeys::fromJson ( Value const& file, ValidatorKeys& keys )
+{
+    if ( !file.isObject ()  ||  !file["key_type"].isString ()
+        ||  !file["public_key"].isString ()
+        ||  !file["secret_key"].isString () )
+        return false;
+
+    std::string const type = file["key_type"].asString ();
+
+    if ( type == "ed25519" )
+        keys.keyType = KeyType::ed25519;
+    else if ( type == "secp256k1" )
+        keys.keyType = KeyType::secp256k1;
+    else
+        return false;
+
+    if ( file.isMember ( "token_sequence" ) )
+    {
+        if ( !file["token_sequence"].isIntegral () )
+            return false;
+
+        keys.tokenSequence = file["token_sequence"].asUInt ();
+    }
+    else
+    {
+        keys.tokenSequence = 0;
+    }
+
+    std::string const text = file["secret_key"].asString ();
+    std::string secret;
+
+    if ( !base58CheckDecode ( tokenNodePrivate, text.data (),
+            text.data () + text.size (), secret )
+        ||  secret.size () != keys.secretKey.size () )
+        return false;
+
+    KeyGenerator generator ( keys.keyType );
+
+    return generator.derive (
+            reinterpret_cast<std::uint8_t const*> ( secret.data () ), keys )
+        &&  keys.publicKeyText () == file["public_key"].asString ();
+}
+
+//------------------------------------------------------------------------------
+
+bool
+sign ( ValidatorKeys const& keys, std::string const& message,
+       std::string& signature )
+{
+    signature.clear ();
+
+    if ( keys.keyType == KeyType::ed25519 )
+    {
+        EVP_PKEY* key = EVP_PKEY_new_raw_private_key ( EVP_PKEY_ED25519,
+            nullptr, keys.secretKey.data (), keys.secretKey.size () );
+        EVP_MD_CTX* context = EVP_MD_CTX_new ();
+        std::uint8_t bytes[64];
+        std::size_t size = sizeof ( bytes );
+        bool const ok = key  &&  context
+            &&  EVP_DigestSignInit ( context, nullptr, nullptr, nullptr, key ) == 1
+            &&  EVP_DigestSign ( context, bytes, &size,
+                    reinterpret_cast<std::uint8_t const*> ( message.data () ),
+                    message.size () ) == 1;
+        EVP_MD_CTX_free ( context );
+        EVP_PKEY_free ( key );
+
+        if ( ok )
+            signature.assign ( bytes, bytes + size );
+
+        return ok;
+    }
+
+    std::uint8_t digest[32];
+    sha512Half ( message, digest );
+
+    EVP_PKEY* key = secp256k1Key (
+        keys.publicKey.data (), keys.secretKey.data () );
+    EVP_PKEY_CTX* context = key ? EVP_PKEY_CTX_new ( key, nullptr ) : nullptr;
+    std::uint8_t der[80];
+    std::size_t size = sizeof ( der );
+    bool ok = context  &&  EVP_PKEY_sign_init ( context ) == 1
+        &&  EVP_PKEY_sign ( context, der, &size, digest, sizeof ( digest ) ) == 1;
+    EVP_PKEY_CTX_free ( context );
+    EVP_PKEY_free ( key );
+
+    // Replace a high S with its negation, which is equally valid.
+    std::uint8_t const* p = der;
+    ECDSA_SIG* parsed = ok ? d2i_ECDSA_SIG ( nullptr, &p, size ) : nullptr;
+    ok = parsed != nullptr;
+
+    if ( ok )
+    {
+        BIGNUM const* r;
+        BIGNUM const* s;
+        ECDSA_SIG_get0 ( parsed, &r, &s );
+        Order const& order = secp256k1Order ();
+
+        if ( BN_cmp ( s, order.half ) > 0 )
+        {
+            BIGNUM* low = BN_new ();
+            BN_sub ( low, order.order, s );
+            ECDSA_SIG_set0 ( parsed, BN_dup ( r ), low );
+        }
+
+        std::uint8_t* out = der;
+        int const length = i2d_ECDSA_SIG ( parsed, &out );
+        ok = length > 0;
+
+        if ( ok )
+            signature.assign ( der, der + length );
+    }
+
+    ECDSA_SIG_free ( parsed );
+    return ok;
+}
+
+bool
+verify ( std::array<std::uint8_t, 33> const& publicKey,
+         std::string const& message, std::string const& signature )
+{
+    auto const* bytes =
+        reinterpret_cast<std::uint8_t const*> ( signature.data () );
+
+    if ( publicKey[0] == 0xED )
+    {
+        EVP_PKEY* key = EVP_PKEY_new_raw_public_key ( EVP_PKEY_ED25519,
+            nullptr, publicKey.data () + 1, publicKey.size () - 1 );
+        EVP_MD_CTX* context = EVP_MD_CTX_new ();
+        bool const ok = key  &&  context
+            &&  EVP_DigestVerifyInit ( context, nullptr, nullptr, nullptr, key ) == 1
+            &&  EVP_DigestVerify ( context, bytes, signature.size (),
+                    reinterpret_cast<std::uint8_t const*> ( message.data () ),
+                    message.size () ) == 1;
+        EVP_MD_CTX_free ( context );
+        EVP_PKEY_free ( key );
+        return ok;
+    }
+
+    // Only strict DER with a low S is accepted.
+    std::uint8_t const* p = bytes;
+    ECDSA_SIG* parsed = d2i_ECDSA_SIG ( nullptr, &p, signature.size () );
+    bool ok = parsed  &&  p == bytes + signature.size ()
+        &&  i2d_ECDSA_SIG ( parsed, nullptr ) ==
+                static_cast<int> ( signature.size () );
+
+    if ( ok )
+    {
+        BIGNUM const* r;
+        BIGNUM const* s;
+        ECDSA_SIG_get0 ( parsed, &r, &s );
+        ok = BN_cmp ( s, secp256k1Order ().half ) <= 0;
+    }
+
+    ECDSA_SIG_free ( parsed );
+
+    if ( !ok )
+        return false;
+
+    std::uint8_t digest[32];
+    sha512Half ( message, digest );
+
+    EVP_PKEY* key = secp256k1Key ( publicKey.data (), nullptr );
+    EVP_PKEY_CTX* context = key ? EVP_PKEY_CTX_new ( key, nullptr ) : nullptr;
+    ok = context  &&  EVP_PKEY_verify_init ( context ) == 1
+        &&  EVP_PKEY_verify ( context, bytes, signature.size (),
+                digest, sizeof ( digest ) ) == 1;
+    EVP_PKEY_CTX_free ( context );
+    EVP_PKEY_free ( key );
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+
+bool
+createToken ( ValidatorKeys const& master, ValidatorKeys const& signing,
+              std::uint32_t sequence, std::string& token )
+{
+    std::string const fields =
+        manifestFields ( master.publicKey, signing.publicKey, sequence );
+    std::string const message = manifestMessage ( fields );
+    std::string signature;
+    std::string masterSignature;
+
+    if ( !sign ( signing, message, signature )
+        ||  !sign ( master, message, masterSignature ) )
+        return false;
+
+    // Signature and MasterSignature follow the signed fields.
+    std::string manifest = fields;
+    manifest += '\x76';
+    manifest += static_cast<char> ( signature.size () );
+    manifest += signature;
+    manifest += "\x70\x12";
+    manifest += static_cast<char> ( masterSignature.size () );
+    manifest += masterSignature;
+
+    std::string text = "{\"manifest\":\"";
+    base64Encode ( manifest.data (), manifest.size (), text );
+    text += "\",\"validation_secret_key\":\"";
+    text += toHex ( signing.secretKey.data (), signing.secretKey.size () );
+    text += "\"}";
+
+    token.clear ();
+    base64Encode ( text.data (), text.size (), token );
+    return true;
+}
+
+bool
+checkToken ( std::string const& token, ValidatorKeys const& master,
+             std::uint32_t sequence, std::string& errors )
+{
+    auto fail = [&errors] ( std::string const& message )
+    {
+        errors = message;
+        return false;
+    };
+
+    std::string text;
+
+    if ( !base64Decode ( token.data (), token.data () + token.size (), text ) )
+        return fail ( "The token is not base64." );
+
+    Reader reader;
+    Value object;
+
+    if ( !reader.parse ( text, object ) )
+        return fail ( "The token is not JSON:\n" +
+            reader.getFormatedErrorMessages () );
+
+    if ( !object["manifest"].isString ()
+        ||  !object["validation_secret_key"].isString () )
+        return fail ( "The token lacks a manifest or secret key." );
+
+    std::string const encoded = object["manifest"].asString ();
+    std::string manifest;
+
+    if ( !base64Decode ( encoded.data (), encoded.data () + encoded.size (),
+            manifest ) )
+        return fail ( "The manifest is not base64." );
+
+    SerializedWriter writer;
+    Value fields;
+
+    if ( !writer.write ( manifest.data (), manifest.size () ) )
+        return fail ( "The manifest is malformed:\n" +
+            writer.getFormatedErrorMessages () );
+
+    if ( !reader.parse ( writer.text (), fields ) )
+        return fail ( "The manifest is malformed:\n" +
+            reader.getFormatedErrorMessages () );
+
+    // Every field must be present and nothing else.
+    char const* const names[] = { "Sequence", "PublicKey", "SigningPubKey",
+        "Signature", "MasterSignature" };
+
+    for ( auto name : names )
+    {
+        if ( !fields.isMember ( name ) )
+            return fail ( std::string ( "The manifest lacks " ) + name + "." );
+    }
+
+    if ( fields.size () != sizeof ( names ) / sizeof ( names[0] ) )
+        return fail ( "The manifest has unexpected fields." );
+
+    std::string bytes;
+    ValidatorKeys signing;
+
+    if ( !fromHex ( fields["SigningPubKey"].asString (), bytes )
+        ||  bytes.size () != signing.publicKey.size () )
+        return fail ( "The signing public key is malformed." );
+
+    std::memcpy ( signing.publicKey.data (), bytes.data (), bytes.size () );
+
+    std::string secret;
+
+    if ( !fromHex ( object["validation_secret_key"].asString (), secret )
+        ||  secret.size () != signing.secretKey.size () )
+        return fail ( "The validation secret key is malformed." );
+
+    ValidatorKeys derived;
+    KeyGenerator generator ( signing.publicKey[0] == 0xED ?
+        KeyType::ed25519 : KeyType::secp256k1 );
+
+    if ( !generator.derive (
+            reinterpret_cast<std::uint8_t const*> ( secret.data () ), derived )
+        ||  derived.publicKey != signing.publicKey )
+        return fail ( "The validation secret key does not match the "
+            "signing public key." );
+
+    if ( !fields["Sequence"].isIntegral ()
+        ||  fields["Sequence"].asUInt () != sequence )
+        return fail ( "The manifest has the wrong sequence." );
+
+    if ( !fromHex ( fields["PublicKey"].asString (), bytes )
+        ||  bytes != std::string ( master.publicKey.begin (),
+                master.publicKey.end () ) )
+        return fail ( "The manifest is for another master key." );
+
+    std::string const message = manifestMessage (
+        manifestFields ( master.publicKey, signing.publicKey, sequence ) );
+
+    if ( !fromHex ( fields["Signature"].asString (), bytes )
+        ||  !verify ( signing.publicKey, message, bytes ) )
+        return fail ( "The signature is invalid." );
+
+    if ( !fromHex ( fields["MasterSignature"].asString (), bytes )
+        ||  !verify ( master.publicKey, message, bytes ) )
+        return fail ( "The master signature is invalid." );
+
+    errors.clear ();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+
+struct KeyGenerator::Curve
+{
+    EC_GROUP* group = nullptr;
+    BN_CTX* context = nullptr;
+    BIGNUM* scalar = nullptr;
+    BIGNUM* limit = nullptr;
+    std::vector<EC_POINT*> points;
+
+    Curve ()
+        : group ( EC_GROUP_new_by_curve_name ( NID_secp256k1 ) )
+        , context ( BN_CTX_new () )
+        , scalar ( BN_new () )
+        , limit ( BN_new () )
+    {
+        if ( !group  ||  !context  ||  !scalar  ||  !limit )
+        {
+            release ();
+            throw std::runtime_error ( "secp256k1 is not available" );
+        }
+    }
+
+    ~Curve ()
+    {
+        release ();
+    }
+
+    void release ()
+    {
+        for ( auto point : points )
+            EC_POINT_free ( point );
+
+        BN_free ( limit );
+        BN_free ( scalar );
+        BN_CTX_free ( context );
+        EC_GROUP_free ( group );
+    }
+
+    void encode ( EC_POINT const* point, std::uint8_t* out )
+    {
+        EC_POINT_point2oct ( group, point, POINT_CONVERSION_COMPRESSED,
+            out, 33, context );
+    }
+};
+
+KeyGenerator::KeyGenerator ( KeyType type )
+    : type_ ( type )
+{
+    if ( type_ == KeyType::secp256k1 )
+        curve_.reset ( new Curve );
+}
+
+KeyGenerator::~KeyGenerator () = default;
+
+bool
+KeyGenerator::derive ( std::uint8_t const* secret, ValidatorKeys& keys )
+{
+    keys.keyType = type_;
+    std::memcpy ( keys.secretKey.data (), secret, keys.secretKey.size () );
+
+    if ( type_ == KeyType::ed25519 )
+    {
+        EVP_PKEY* key = EVP_PKEY_new_raw_private_key ( EVP_PKEY_ED25519,
+            nullptr, secret, keys.secretKey.size () );
+        std::size_t size = keys.publicKey.size () - 1;
+        bool const ok = key  &&  EVP_PKEY_get_raw_public_key (
+            key, keys.publicKey.data () + 1, &size ) == 1;
+        EVP_PKEY_free ( key );
+        keys.publicKey[0] = 0xED;
+        return ok;
+    }
+
+    Curve& curve = *curve_;
+    BN_bin2bn ( secret, keys.secretKey.size (), curve.scalar );
+
+    if ( BN_is_zero ( curve.scalar )
+        ||  BN_cmp ( curve.scalar, EC_GROUP_get0_order ( curve.group ) ) >= 0 )
+        return false;
+
+    if ( curve.points.empty () )
+        curve.points.push_back ( EC_POINT_new ( curve.group ) );
+
+    if ( !EC_POINT_mul ( curve.group, curve.points[0], curve.scalar,
+            nullptr, nullptr, curve.context ) )
+        return false;
+
+    curve.encode ( curve.points[0], keys.publicKey.data () );
+    return true;
+}
+
+void
+KeyGenerator::generate ( std::vector<ValidatorKeys>& batch )
+{
+    std::vector<std::uint8_t> secrets ( batch.size () * 32 );
+    randomBytes ( secrets.data (), secrets.size () );
+
+    for ( std::size_t i = 0; i < batch.size (); ++i )
+    {
+        std::uint8_t* const secret = secrets.data () + i * 32;
+
+        // Draw again the rare secret outside the secp256k1 group.
+        while ( !derive ( secret, batch[i] ) )
+        {
+            if ( type_ == KeyType::ed25519 )
+                throw std::runtime_error ( "Ed25519 key derivation failed" );
+
+            randomBytes ( secret, 32 );
+        }
+    }
+}
+
+void
+KeyGenerator::generateCandidates ( std::vector<ValidatorKeys>& batch )
+{
+    if ( type_ == KeyType::secp256k1  &&  !batch.empty () )
+        generateConsecutive ( batch );
+    else
+        generate ( batch );
+}
+
+void
+KeyGenerator::generateConsecutive ( std::vector<ValidatorKeys>& batch )
+{
+    // The public keys of s, s + 1, ... are sG, sG + G, sG + 2G, ...
+    Curve& curve = *curve_;
+    std::size_t const n = batch.size ();
+
+    while ( curve.points.size () < n )
+        curve.points.push_back ( EC_POINT_new ( curve.group ) );
+
+    // The last secret, s + n - 1, must stay below the group order.
+    BN_copy ( curve.limit, EC_GROUP_get0_order ( curve.group ) );
+    BN_sub_word ( curve.limit, n );
+
+    std::uint8_t secret[32];
+
+    do
+    {
+        randomBytes ( secret, sizeof ( secret ) );
+        BN_bin2bn ( secret, sizeof ( secret ), curve.scalar );
+    }
+    while ( BN_is_zero ( curve.scalar )
+        ||  BN_cmp ( curve.scalar, curve.limit ) >= 0 );
+
+    EC_POINT const* generator = EC_GROUP_get0_generator ( curve.group );
+    bool ok = EC_POINT_mul ( curve.group, curve.points[0], curve.scalar,
+        nullptr, nullptr, curve.context );
+
+    for ( std::size_t i = 1; ok  &&  i < n; ++i )
+        ok = EC_POINT_add ( curve.group, curve.points[i], curve.points[i - 1],
+            generator, curve.context );
+
+    if ( !ok )
+        throw std::runtime_error ( "secp256k1 key derivation failed" );
+
+    for ( std::size_t i = 0; i < n; ++i )
+    {
+        ValidatorKeys& keys = batch[i];
+        keys.keyType = KeyType::secp256k1;
+        BN_bn2binpad ( curve.scalar, keys.secretKey.data (),
+            keys.secretKey.size () );
+        curve.encode ( curve.points[i], keys.publicKey.data () );
+        BN_add_word ( curve.scalar, 1 );
+    }
+}
+
+//------------------------------------------------------------------------------
+
+KeySearch::KeySearch ( KeyType type, unsigned threads )
+    : type_ ( type )
+    , threads_ ( threads ? threads : std::thread::hardware_concurrency () )
+{
+    if ( threads_ < 1 )
+        threads_ = 1;
+}
+
+bool
+KeySearch::setPrefix ( std::string const& prefix )
+{
+    if ( !prefix.empty ()  &&  prefix[0] != 'n' )
+        return false;
+
+    for ( char c : prefix )
+    {
+        if ( c == 0  ||  !std::strchr ( base58Alphabet, c ) )
+            return false;
+    }
+
+    prefix_ = prefix;
+    pattern_.reset ();
+    return true;
+}
+
+bool
+KeySearch::setPattern ( std::string const& pattern )
+{
+    try
+    {
+        pattern_.reset ( new std::regex ( pattern,
+            std::regex::ECMAScript | std::regex::optimize ) );
+    }
+    catch ( std::regex_error const& )
+    {
+        return false;
+    }
+
+    prefix_.clear ();
+    return true;
+}
+
+void
+KeySearch::setLimit ( std::uint64_t attempts )
+{
+    limit_ = attempts;
+}
+
+bool
+KeySearch::matches ( std::string const& text ) const
+{
+    if ( pattern_ )
+        return std::regex_search ( text, *pattern_ );
+
+    return text.compare ( 0, prefix_.size (), prefix_ ) == 0;
+}
+
+bool
+KeySearch::run ( ValidatorKeys& keys )
+{
+    auto const start = std::chrono::steady_clock::now ();
+    std::atomic<bool> found ( false );
+    std::atomic<std::uint64_t> claimed ( 0 );
+    std::atomic<std::uint64_t> attempts ( 0 );
+    std::exception_ptr error;
+    std::mutex mutex;
+
+    auto search = [&]
+    {
+        try
+        {
+            KeyGenerator generator ( type_ );
+            std::vector<ValidatorKeys> batch ( batchSize );
+            std::string text;
+
+            while ( !found.load ( std::memory_order_relaxed ) )
+            {
+                std::uint64_t count = batch.size ();
+
+                if ( limit_ != 0 )
+                {
+                    // Claim the batch before generating it, so that the
+                    // threads together stop at exactly the limit.
+                    std::uint64_t const first = claimed.fetch_add ( count );
+
+                    if ( first >= limit_ )
+                        break;
+
+                    count = std::min ( count, limit_ - first );
+                }
+
+                generator.generateCandidates ( batch );
+                std::uint64_t i = 0;
+
+                while ( i < count )
+                {
+                    text.clear ();
+                    base58CheckEncode ( tokenNodePublic,
+                        batch[i].publicKey.data (), batch[i].publicKey.size (),
+                        text );
+
+                    if ( matches ( text ) )
+                        break;
+
+                    ++i;
+                }
+
+                attempts += std::min ( i + 1, count );
+
+                if ( i < count )
+                {
+                    if ( !found.exchange ( true ) )
+                        keys = batch[i];
+
+                    break;
+                }
+            }
+        }
+        catch ( ... )
+        {
+            // Stop the other threads and rethrow on the calling thread.
+            std::lock_guard<std::mutex> lock ( mutex );
+
+            if ( !error )
+                error = std::current_exception ();
+
+            found = true;
+        }
+    };
+
+    std::vector<std::thread> workers;
+    workers.reserve ( threads_ - 1 );
+
+    for ( unsigned t = 1; t < threads_; ++t )
+        workers.emplace_back ( search );
+
+    search ();
+
+    for ( auto& worker : workers )
+        worker.join ();
+
+    if ( error )
+        std::rethrow_exception ( error );
+
+    attempts_ = attempts;
+    seconds_ = std::chrono::duration<double> (
+        std::chrono::steady_clock::now () - start ).count ();
+    return found;
+}
+
+std::uint64_t
+KeySearch::attempts () const
+{
+    return attempts_;
+}
+
+double
+KeySearch::seconds () const
+{
+    return seconds_;
+}
+
+double
+KeySearch::keysPerSecond () const
+{
+    return seconds_ > 0 ? attempts_ / seconds_ : 0;
+}
+
+} // namespace Json
@@ -0,0 +1,211 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#ifndef RIPPLE_JSON_JSON_VALIDATOR_KEYS_H_INCLUDED
+#define RIPPLE_JSON_JSON_VALIDATOR_KEYS_H_INCLUDED
+
+#include <ripple/json/json_value.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <string>
+#include <vector>
+
+namespace Json
+{
+
+/// \brief The signature scheme of a validator key pair.
+enum class KeyType
+{
+    secp256k1,
+    ed25519
+};
+
+/// \brief A validator key pair, as held in a validator key file.
+struct ValidatorKeys
+{
+    KeyType keyType = KeyType::ed25519;
+    std::array<std::uint8_t, 32> secretKey;
+    std::array<std::uint8_t, 33> publicKey;    ///< Compressed, or 0xED and the key
+    std::uint32_t tokenSequence = 0;            ///< Sequence of the last token
+
+    /// \brief The base58 node public key, starting with 'n'.
+    std::string publicKeyText () const;
+
+    /// \brief The base58 node private key, starting with 'p'.
+    std::string secretKeyText () const;
+
+    /** \brief The key file: \c key_type, \c public_key, \c revoked,
+     *         \c secret_key and \c token_sequence.
+     */
+    Value toJson () const;
+
+    /** \brief Read a key file, deriving the public key from the secret key
+     *         and checking that it matches \c public_key.
+     * \return \c true if \a file is a valid key file, \c false otherwise.
+     */
+    static bool fromJson ( Value const& file, ValidatorKeys& keys );
+};
+
+/** \brief Sign \a message as rippled does.
+
+    Ed25519 keys sign the message itself. secp256k1 keys sign the first
+    half of its SHA-512, giving a DER encoded signature whose S is in the
+    lower half of the group order.
+    \return \c false if OpenSSL failed to sign.
+*/
+bool sign ( ValidatorKeys const& keys, std::string const& message,
+            std::string& signature );
+
+/** \brief Check a signature made by sign().
+ * secp256k1 signatures whose S is in the upper half of the group order are
+ * rejected, as rippled rejects them.
+ */
+bool verify ( std::array<std::uint8_t, 33> const& publicKey,
+              std::string const& message, std::string const& signature );
+
+/** \brief Create a validator token.
+
+    The token lets \a signing, an ephemeral key pair, validate for the
+    \a master key pair. It is the base64 encoding of a JSON object whose
+    \c manifest is the base64 manifest, signed by both key pairs, and whose
+    \c validation_secret_key is the ephemeral secret key in hex.
+    \return \c false if a signature could not be made.
+*/
+bool createToken ( ValidatorKeys const& master, ValidatorKeys const& signing,
+                   std::uint32_t sequence, std::string& token );
+
+/** \brief Check a token made by createToken() for \a master.
+
+    The token and its manifest are read back through Reader and
+    SerializedWriter, the manifest fields compared with \a master and
+    \a sequence, and both signatures verified.
+    \param errors [out] Why the token was rejected.
+*/
+bool checkToken ( std::string const& token, ValidatorKeys const& master,
+                  std::uint32_t sequence, std::string& errors );
+
+/** \brief Derives validator key pairs from secret keys.
+
+    A generator holds the curve state for one thread and is not safe to
+    share. Generating in batches amortises the work that does not depend on
+    the individual key: one call to the random number generator fills every
+    secret of a batch.
+*/
+class KeyGenerator
+{
+public:
+    explicit KeyGenerator ( KeyType type );
+    ~KeyGenerator ();
+
+    KeyGenerator ( KeyGenerator const& ) = delete;
+    KeyGenerator& operator= ( KeyGenerator const& ) = delete;
+
+    /** \brief Derive the key pair for one secret key.
+     * \return \c false if \a secret is not a valid secp256k1 scalar.
+     */
+    bool derive ( std::uint8_t const* secret, ValidatorKeys& keys );
+
+    /// \brief Fill \a batch with new, independent random key pairs.
+    void generate ( std::vector<ValidatorKeys>& batch );
+
+    /** \brief Fill \a batch with candidates for a search.
+     *
+     * secp256k1 candidates have the consecutive secrets s, s + 1, ... from
+     * a random start s, so that each public key after the first is one
+     * point addition away from the previous instead of a full scalar
+     * multiplication. Knowing one of these secrets reveals the others, so
+     * at most one key pair of a batch may be kept.
+     */
+    void generateCandidates ( std::vector<ValidatorKeys>& batch );
+
+private:
+    void generateConsecutive ( std::vector<ValidatorKeys>& batch );
+
+    struct Curve;
+
+    KeyType type_;
+    std::unique_ptr<Curve> curve_;
+};
+
+/** \brief Search for a validator key pair with a chosen public key.
+
+    Operators like to recognise their validators' keys at a glance. Since
+    the node public key is a hash of nothing the operator controls, the
+    only way to choose its text is to generate key pairs until one matches.
+    The search runs on several threads, each with its own KeyGenerator and
+    random number stream, and stops at the first match found by any of them.
+*/
+class KeySearch
+{
+public:
+    /** \brief Create a search that uses \a threads threads.
+     * Zero means one thread per hardware thread.
+     */
+    explicit KeySearch ( KeyType type, unsigned threads = 0 );
+
+    /** \brief Accept keys whose node public key starts with \a prefix.
+     * \return \c false if \a prefix holds a character outside the base58
+     *         alphabet or does not start with 'n', so no key could match.
+     */
+    bool setPrefix ( std::string const& prefix );
+
+    /** \brief Accept keys whose node public key contains a match for the
+     *         ECMAScript regular expression \a pattern.
+     * \return \c false if \a pattern is not a valid regular expression.
+     */
+    bool setPattern ( std::string const& pattern );
+
+    /** \brief Give up after \a attempts key pairs in total.
+     * Zero, the default, searches until a match is found.
+     */
+    void setLimit ( std::uint64_t attempts );
+
+    /** \brief Generate key pairs until one matches.
+     * \param keys [out] The first matching key pair found.
+     * \return \c true if a match was found, \c false if the limit was
+     *         reached first.
+     */
+    bool run ( ValidatorKeys& keys );
+
+    /// \brief The number of key pairs generated by the last run.
+    std::uint64_t attempts () const;
+
+    /// \brief The duration of the last run.
+    double seconds () const;
+
+    /// \brief The rate at which the last run generated key pairs.
+    double keysPerSecond () const;
+
+private:
+    bool matches ( std::string const& text ) const;
+
+    KeyType type_;
+    unsigned threads_;
+    std::string prefix_;
+    std::unique_ptr<std::regex> pattern_;
+    std::uint64_t limit_ = 0;
+    std::uint64_t attempts_ = 0;
+    double seconds_ = 0;
+};
+
+} // namespace Json
+
+#endif
@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_base64.h>
+#include <ripple/beast/unit_test.h>
+#include <string>
+
+namespace ripple {
+
+class json_base64_test : public beast::unit_test::suite
+{
+public:
+    // The decoded bytes, or "!" if the text is rejected.
+    static std::string
+    decode ( std::string const& text )
+    {
+        std::string out;
+
+        if ( !Json::base64Decode ( text.data (), text.data () + text.size (), out ) )
+            return "!";
+
+        return out;
+    }
+
+    static std::string
+    encode ( std::string const& bytes )
+    {
+        std::string out;
+        Json::base64Encode ( bytes.data (), bytes.size (), out );
+        return out;
+    }
+
+    void
+    testPadding ()
+    {
+        testcase ("padding");
+
+        // RFC 4648, section 10.
+        char const* const vectors[][2] =
+        {
+            { "", "" },
+            { "f", "Zg==" },
+            { "fo", "Zm8=" },
+            { "foo", "Zm9v" },
+            { "foob", "Zm9vYg==" },
+            { "fooba", "Zm9vYmE=" },
+            { "foobar", "Zm9vYmFy" }
+        };
+
+        for ( auto const& v : vectors )
+        {
+            std::string const text = v[1];
+            BEAST_EXPECT ( encode ( v[0] ) == text );
+            BEAST_EXPECT ( decode ( text ) == v[0] );
+
+            // Padding is optional, but must be complete if present.
+            auto const data = text.substr ( 0, text.find ( '=' ) );
+            BEAST_EXPECT ( decode ( data ) == v[0] );
+
+            if ( data.size () != text.size () )
+            {
+                BEAST_EXPECT ( decode ( data + "===" ) == "!" );
+
+                if ( text.size () - data.size () == 2 )
+                    BEAST_EXPECT ( decode ( data + "=" ) == "!" );
+            }
+            else if ( !data.empty () )
+            {
+                BEAST_EXPECT ( decode ( data + "=" ) == "!" );
+            }
+        }
+
+        // A single character left over is never valid.
+        BEAST_EXPECT ( decode ( "Zm9vY" ) == "!" );
+        BEAST_EXPECT ( decode ( "Zm9vY===" ) == "!" );
+
+        // Nothing but whitespace may follow the padding.
+        BEAST_EXPECT ( decode ( "Zg==Zg==" ) == "!" );
+        BEAST_EXPECT ( decode ( "Zg== \n" ) == "f" );
+        BEAST_EXPECT ( decode ( "=" ) == "!" );
+
+        // Every byte value survives a round trip.
+        std::string all;
+
+        for ( int i = 0; i < 256; ++i )
+            all += static_cast<char> ( i );
+
+        BEAST_EXPECT ( decode ( encode ( all ) ) == all );
+    }
+
+    void
+    testCanonical ()
+    {
+        testcase ("canonical");
+
+        // The unused bits of the last group must be zero.
+        BEAST_EXPECT ( decode ( "QQ==" ) == "A" );
+        BEAST_EXPECT ( decode ( "QR==" ) == "!" );
+        BEAST_EXPECT ( decode ( "QR" ) == "!" );
+        BEAST_EXPECT ( decode ( "Qf==" ) == "!" );
+        BEAST_EXPECT ( decode ( "QUI=" ) == "AB" );
+        BEAST_EXPECT ( decode ( "QUJ=" ) == "!" );
+        BEAST_EXPECT ( decode ( "QUL" ) == "!" );
+    }
+
+    void
+    testWrapped ()
+    {
+        testcase ("wrapped");
+
+        std::string bytes;
+
+        for ( int i = 0; i < 200; ++i )
+            bytes += static_cast<char> ( i * 7 );
+
+        std::string const text = encode ( bytes );
+
+        // Wrapped at any width, with LF, CR LF, spaces or tabs, and
+        // breaking the four character groups.
+        for ( std::size_t width : { 1, 3, 64, 76 } )
+        {
+            for ( std::string const separator : { "\n", "\r\n", " ", "\t \n" } )
+            {
+                std::string wrapped = separator;
+
+                for ( std::size_t i = 0; i < text.size (); i += width )
+                    wrapped += text.substr ( i, width ) + separator;
+
+                expect ( decode ( wrapped ) == bytes,
+                    "width " + std::to_string ( width ) );
+            }
+        }
+
+        BEAST_EXPECT ( decode ( "Zm9v\nYg\n=\n=" ) == "foob" );
+    }
+
+    void
+    testInvalid ()
+    {
+        testcase ("invalid");
+
+        // Characters outside the alphabet, anywhere in the text.
+        for ( char c : { '-', '_', '.', '*', '\0', '\x80', '\xff', '\v' } )
+        {
+            std::string const text = "Zm9vYmFy";
+
+            for ( std::size_t at = 0; at <= text.size (); ++at )
+            {
+                std::string changed = text;
+                changed.insert ( at, 1, c );
+                expect ( decode ( changed ) == "!",
+                    "character " + std::to_string ( static_cast<unsigned char> ( c ) ) +
+                    " at " + std::to_string ( at ) );
+            }
+        }
+
+        // Padding inside the data.
+        BEAST_EXPECT ( decode ( "Zm=9v" ) == "!" );
+        BEAST_EXPECT ( decode ( "=Zm9v" ) == "!" );
+    }
+
+    void
+    run () override
+    {
+        testPadding ();
+        testCanonical ();
+        testWrapped ();
+        testInvalid ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_base64, json, ripple);
+
+} // ripple
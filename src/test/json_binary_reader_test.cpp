@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_binary_reader.h>
+#include <ripple/beast/unit_test.h>
+#include <string>
+
+namespace ripple {
+
+class json_binary_reader_test : public beast::unit_test::suite
+{
+    static bool
+    parse ( Json::BinaryReader::Format format, std::string const& document,
+            Json::Value& root )
+    {
+        return Json::BinaryReader ( format ).parse ( document, root );
+    }
+
+public:
+    void
+    testCbor ()
+    {
+        testcase ("cbor");
+
+        using Json::BinaryReader;
+        Json::Value root;
+
+        // {"a": [1, -2, 1.5]}
+        BEAST_EXPECT ( parse ( BinaryReader::cbor,
+            std::string ( "\xa1\x61" "a" "\x83\x01\x21\xf9\x3e\x00", 9 ), root ) );
+        BEAST_EXPECT ( root["a"][2u].asDouble () == 1.5 );
+        BEAST_EXPECT ( root["a"][1u].asInt () == -2 );
+
+        // A tagged item reads as the item.
+        BEAST_EXPECT ( parse ( BinaryReader::cbor, "\xc6\xc6\x80", root ) );
+        BEAST_EXPECT ( root.isArray ()  &&  root.size () == 0 );
+
+        // Long chains of tags must not exhaust the stack.
+        std::string tags ( 2000000, '\xc6' );
+        BEAST_EXPECT ( parse ( BinaryReader::cbor, tags + "\x80", root ) );
+        BEAST_EXPECT ( !parse ( BinaryReader::cbor, tags, root ) );
+
+        // Nesting is limited as for JSON text.
+        BEAST_EXPECT ( parse ( BinaryReader::cbor, std::string ( 25, '\x81' ) + "\x80", root ) );
+        BEAST_EXPECT ( !parse ( BinaryReader::cbor, std::string ( 26, '\x81' ) + "\x80", root ) );
+    }
+
+    void
+    testNonFinite ()
+    {
+        testcase ("non-finite");
+
+        using Json::BinaryReader;
+        Json::Value root;
+
+        // [NaN] and [Infinity] as half, single and double floats.
+        BEAST_EXPECT ( !parse ( BinaryReader::cbor,
+            std::string ( "\x81\xf9\x7e\x00", 4 ), root ) );
+        BEAST_EXPECT ( !parse ( BinaryReader::cbor,
+            std::string ( "\x81\xf9\x7c\x00", 4 ), root ) );
+        BEAST_EXPECT ( !parse ( BinaryReader::cbor,
+            std::string ( "\x81\xfa\x7f\x80\x00\x00", 6 ), root ) );
+        BEAST_EXPECT ( !parse ( BinaryReader::cbor,
+            std::string ( "\x81\xfb\xff\xf0\x00\x00\x00\x00\x00\x00", 10 ), root ) );
+
+        BEAST_EXPECT ( !parse ( BinaryReader::messagePack,
+            std::string ( "\x91\xca\x7f\xc0\x00\x00", 6 ), root ) );
+        BEAST_EXPECT ( !parse ( BinaryReader::messagePack,
+            std::string ( "\x91\xcb\x7f\xf0\x00\x00\x00\x00\x00\x00", 10 ), root ) );
+
+        // Finite values still read.
+        BEAST_EXPECT ( parse ( BinaryReader::messagePack,
+            std::string ( "\x91\xcb\x3f\xf8\x00\x00\x00\x00\x00\x00", 10 ), root ) );
+        BEAST_EXPECT ( root[0u].asDouble () == 1.5 );
+    }
+
+    void
+    run () override
+    {
+        testCbor ();
+        testNonFinite ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_binary_reader, json, ripple);
+
+} // ripple
@@ -0,0 +1,139 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_diff.h>
+#include <ripple/beast/unit_test.h>
+#include <chrono>
+#include <string>
+
+namespace ripple {
+
+class json_diff_test : public beast::unit_test::suite
+{
+public:
+    void
+    testPatch ()
+    {
+        testcase ("patch");
+
+        Json::Differ differ;
+        Json::Value patch;
+
+        BEAST_EXPECT ( differ.diff ( "{\"a\":[1,2],\"b\":{\"c\":1}}",
+            "{\"a\":[1,2,3],\"b\":{\"d\":1}}", patch ) );
+        BEAST_EXPECT ( patch.size () == 3 );
+
+        BEAST_EXPECT ( differ.diff ( "{\"a\":1}", "{\"a\":1}", patch ) );
+        BEAST_EXPECT ( patch.size () == 0 );
+
+        // Comments take the full parse, with the same result.
+        BEAST_EXPECT ( differ.diff ( "{\"a\":1 /* x */,\"b\":1}",
+            "{\"a\":1,\"b\":2}", patch ) );
+        BEAST_EXPECT ( patch.size () == 1 );
+    }
+
+    void
+    testInvalid ()
+    {
+        testcase ("invalid");
+
+        Json::Differ differ;
+        Json::Value patch;
+
+        // Differing parts are validated.
+        BEAST_EXPECT ( !differ.diff ( "{\"a\":1}", "{\"a\":tru}", patch ) );
+        BEAST_EXPECT ( !differ.getFormatedErrorMessages ().empty () );
+
+        // So are the member names of compared objects.
+        BEAST_EXPECT ( !differ.diff ( "{\"a\":1,\"a\":1,\"b\":1}",
+            "{\"a\":1,\"a\":1,\"b\":2}", patch ) );
+
+        // Identical text is not, as documented.
+        BEAST_EXPECT ( differ.diff ( "{\"a\":tru,\"b\":1}",
+            "{\"a\":tru,\"b\":2}", patch ) );
+        BEAST_EXPECT ( patch.size () == 1 );
+    }
+
+    void
+    testNesting ()
+    {
+        testcase ("nesting");
+
+        // Arrays nested depth deep around a value.
+        auto const nested = [] ( std::size_t depth, std::string const& value )
+        {
+            return std::string ( depth, '[' ) + value + std::string ( depth, ']' );
+        };
+
+        Json::Differ differ;
+        Json::Value patch;
+
+        // Reader accepts 26 levels, with the root at depth 0.
+        BEAST_EXPECT ( differ.diff ( nested ( 25, "1" ), nested ( 25, "2" ),
+            patch ) );
+        BEAST_EXPECT ( patch.size () == 1 );
+        BEAST_EXPECT ( differ.diff ( nested ( 26, "" ), nested ( 25, "1" ),
+            patch ) );
+        BEAST_EXPECT ( patch.size () == 1 );
+
+        // Deeper documents fail as Reader fails, even where identical.
+        BEAST_EXPECT ( !differ.diff ( nested ( 30, "1" ), nested ( 30, "2" ),
+            patch ) );
+        BEAST_EXPECT ( differ.getFormatedErrorMessages ().find (
+            "maximum nesting depth" ) != std::string::npos );
+        BEAST_EXPECT ( !differ.diff ( "[1," + nested ( 30, "1" ) + "]",
+            "[2," + nested ( 30, "1" ) + "]", patch ) );
+
+        // Hostile depths fail quickly rather than exhausting the stack.
+        auto const start = std::chrono::steady_clock::now ();
+        BEAST_EXPECT ( !differ.diff ( nested ( 20000, "1" ),
+            nested ( 20000, "2" ), patch ) );
+        BEAST_EXPECT ( std::chrono::steady_clock::now () - start <
+            std::chrono::seconds ( 1 ) );
+
+        // Each level of a deep but valid document is scanned once.
+        std::string from = "{\"a\":1}";
+        std::string to = "{\"a\":2}";
+
+        for ( int i = 0; i < 24; ++i )
+        {
+            std::string const padding ( 4000, ' ' );
+            from = "{\"x\":[" + padding + "1],\"y\":" + from + "}";
+            to = "{\"x\":[" + padding + "1],\"y\":" + to + "}";
+        }
+
+        BEAST_EXPECT ( differ.diff ( from, to, patch ) );
+        BEAST_EXPECT ( patch.size () == 1 );
+        BEAST_EXPECT ( patch[0u]["path"].asString () ==
+            "/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/y/a" );
+    }
+
+    void
+    run () override
+    {
+        testPatch ();
+        testInvalid ();
+        testNesting ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_diff, json, ripple);
+
+} // ripple
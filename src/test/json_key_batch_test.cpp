@@ -0,0 +1,189 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_key_batch.h>
+#include <ripple/beast/unit_test.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace ripple {
+
+class json_key_batch_test : public beast::unit_test::suite
+{
+public:
+    // A directory removed with everything in it when the test ends.
+    struct TemporaryDirectory
+    {
+        boost::filesystem::path path;
+
+        TemporaryDirectory ()
+            : path ( boost::filesystem::temp_directory_path () /
+                boost::filesystem::unique_path () )
+        {
+            boost::filesystem::create_directories ( path );
+        }
+
+        ~TemporaryDirectory ()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all ( path, ec );
+        }
+
+        std::string operator/ ( std::string const& name ) const
+        {
+            return ( path / name ).string ();
+        }
+    };
+
+    static std::string
+    readFile ( std::string const& path )
+    {
+        std::ifstream file ( path, std::ios::binary );
+        std::ostringstream text;
+        text << file.rdbuf ();
+        return text.str ();
+    }
+
+    static void
+    writeFile ( std::string const& path, std::string const& text )
+    {
+        std::ofstream ( path, std::ios::binary ) << text;
+    }
+
+    void
+    testGenerate ()
+    {
+        testcase ("generate");
+
+        for ( auto type : { Json::KeyType::ed25519, Json::KeyType::secp256k1 } )
+        {
+            Json::KeyBatch batch ( type, 3 );
+            BEAST_EXPECT ( batch.generate ( 40 ) );
+            BEAST_EXPECT ( batch.validators ().size () == 40 );
+
+            bool all = true;
+            std::string errors;
+
+            for ( auto const& validator : batch.validators () )
+            {
+                all = all  &&  validator.keys.keyType == type  &&
+                    validator.keys.tokenSequence == 1  &&
+                    Json::checkToken ( validator.token, validator.keys, 1, errors );
+            }
+
+            BEAST_EXPECT ( all );
+            BEAST_EXPECT ( batch.validators ()[0].keys.secretKey !=
+                batch.validators ()[39].keys.secretKey );
+
+            BEAST_EXPECT ( batch.generate ( 0 ) );
+            BEAST_EXPECT ( batch.validators ().empty () );
+        }
+    }
+
+    void
+    testLines ()
+    {
+        testcase ("lines");
+
+        TemporaryDirectory directory;
+        std::string const path = directory / "validators.jsonl";
+
+        Json::KeyBatch batch ( Json::KeyType::ed25519, 4 );
+        BEAST_EXPECT ( batch.generate ( 25 ) );
+        BEAST_EXPECT ( batch.write ( path, Json::KeyBatch::Layout::lines ) );
+        BEAST_EXPECT ( batch.verify ( path, Json::KeyBatch::Layout::lines ) );
+
+        std::string const text = readFile ( path );
+        BEAST_EXPECT ( std::count ( text.begin (), text.end (), '\n' ) == 25 );
+        BEAST_EXPECT ( text.find (
+            "{\"key_file\":{\"key_type\":\"ed25519\"," ) == 0 );
+
+        // Another batch's records are rejected, the first one named.
+        Json::KeyBatch other ( Json::KeyType::ed25519, 4 );
+        BEAST_EXPECT ( other.generate ( 25 ) );
+        BEAST_EXPECT ( !other.verify ( path, Json::KeyBatch::Layout::lines ) );
+        BEAST_EXPECT ( other.getFormatedErrorMessages () ==
+            "Validator 1: the key file holds other keys.\n" );
+
+        // A token swapped between records fails on the first.
+        auto const first = text.find ( "\"token\":\"" ) + 9;
+        auto const second = text.find ( "\"token\":\"", first ) + 9;
+        std::string swapped = text;
+        swapped.replace ( first, text.find ( '"', first ) - first,
+            text.substr ( second, text.find ( '"', second ) - second ) );
+        writeFile ( path, swapped );
+        BEAST_EXPECT ( !batch.verify ( path, Json::KeyBatch::Layout::lines ) );
+        BEAST_EXPECT ( batch.getFormatedErrorMessages () ==
+            "Validator 1: The manifest is for another master key.\n" );
+
+        // A missing record.
+        writeFile ( path, text.substr ( 0, text.rfind ( '\n', text.size () - 2 ) + 1 ) );
+        BEAST_EXPECT ( !batch.verify ( path, Json::KeyBatch::Layout::lines ) );
+        BEAST_EXPECT ( batch.getFormatedErrorMessages () ==
+            "Expected 25 validators but read 24.\n" );
+
+        BEAST_EXPECT ( !batch.verify ( directory / "missing",
+            Json::KeyBatch::Layout::lines ) );
+    }
+
+    void
+    testFiles ()
+    {
+        testcase ("files");
+
+        TemporaryDirectory directory;
+        std::string const path = directory / "keys";
+
+        Json::KeyBatch batch ( Json::KeyType::secp256k1, 3 );
+        BEAST_EXPECT ( batch.generate ( 10 ) );
+        BEAST_EXPECT ( batch.write ( path, Json::KeyBatch::Layout::files ) );
+        BEAST_EXPECT ( batch.verify ( path, Json::KeyBatch::Layout::files ) );
+
+        std::string const keyFile = readFile ( directory / "keys/validator-keys-10.json" );
+        BEAST_EXPECT ( keyFile.find ( "{\"key_type\":\"secp256k1\"," ) == 0 );
+        BEAST_EXPECT ( keyFile.find ( "\"token_sequence\":1}" ) != std::string::npos );
+
+        // A key file that is not JSON is reported with its path.
+        writeFile ( directory / "keys/validator-keys-7.json", "{" );
+        BEAST_EXPECT ( !batch.verify ( path, Json::KeyBatch::Layout::files ) );
+        BEAST_EXPECT ( batch.getFormatedErrorMessages ().find (
+            "validator-keys-7.json':\n" ) != std::string::npos );
+
+        writeFile ( directory / "keys/validator-keys-7.json", keyFile );
+        boost::filesystem::remove ( directory / "keys/validator-token-3.txt" );
+        BEAST_EXPECT ( !batch.verify ( path, Json::KeyBatch::Layout::files ) );
+        BEAST_EXPECT ( batch.getFormatedErrorMessages () ==
+            "Validator 3: unable to read its files.\n" );
+    }
+
+    void
+    run () override
+    {
+        testGenerate ();
+        testLines ();
+        testFiles ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_key_batch, json, ripple);
+
+} // ripple
@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_lines_reader.h>
+#include <ripple/beast/unit_test.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class json_lines_reader_test : public beast::unit_test::suite
+{
+public:
+    void
+    testOrder ()
+    {
+        testcase ("order");
+
+        std::string document;
+
+        for ( int i = 0; i < 1000; ++i )
+            document += "{\"n\":" + std::to_string ( i ) + "}\n";
+
+        for ( unsigned threads : { 1u, 2u, 3u, 7u, 2000u } )
+        {
+            Json::LinesReader reader;
+            std::vector<Json::Value> records;
+            BEAST_EXPECT ( reader.parse ( document, records, threads ) );
+
+            bool ordered = records.size () == 1000;
+
+            for ( std::size_t i = 0; ordered  &&  i < records.size (); ++i )
+                ordered = records[i]["n"].asInt () == static_cast<int> ( i );
+
+            BEAST_EXPECT ( ordered );
+        }
+    }
+
+    void
+    testBlankLines ()
+    {
+        testcase ("blank lines");
+
+        Json::LinesReader reader;
+        std::vector<Json::Value> records;
+
+        // Blank lines, with or without spaces, tabs and CR, hold no record.
+        BEAST_EXPECT ( reader.parse (
+            "\n1\r\n  \n\t\r\n[2]\n\n\"3\"", records, 2 ) );
+        BEAST_EXPECT ( records.size () == 3 );
+        BEAST_EXPECT ( records[0] == 1  &&  records[1][0u] == 2  &&
+            records[2] == "3" );
+
+        BEAST_EXPECT ( reader.parse ( "", records ) );
+        BEAST_EXPECT ( records.empty () );
+        BEAST_EXPECT ( reader.parse ( "\n \n\r\n", records, 4 ) );
+        BEAST_EXPECT ( records.empty () );
+
+        // A record may itself span no more than one line.
+        BEAST_EXPECT ( !reader.parse ( "[1,\n2]", records ) );
+    }
+
+    void
+    testErrors ()
+    {
+        testcase ("errors");
+
+        // Line numbers count blank lines. Of several failing records, the
+        // first is reported whichever thread parses it.
+        std::string document;
+
+        for ( int i = 1; i <= 100; ++i )
+        {
+            if ( i % 10 == 0 )
+                document += "\n";
+            else if ( i == 35  ||  i == 80 )
+                document += "{\"bad\":}\n";
+            else
+                document += std::to_string ( i ) + "\n";
+        }
+
+        for ( unsigned threads : { 1u, 2u, 4u, 16u } )
+        {
+            Json::LinesReader reader;
+            std::vector<Json::Value> records;
+            BEAST_EXPECT ( !reader.parse ( document, records, threads ) );
+            BEAST_EXPECT ( reader.getFormatedErrorMessages ().compare (
+                0, 28, "In the record on line 35:\n* " ) == 0 );
+        }
+
+        // A failure only in the last thread's share is still found.
+        Json::LinesReader reader;
+        std::vector<Json::Value> records;
+        BEAST_EXPECT ( !reader.parse ( "1\n2\n3\n4\n5\n6\n7\n[", records, 4 ) );
+        BEAST_EXPECT ( reader.getFormatedErrorMessages ().compare (
+            0, 27, "In the record on line 8:\n* " ) == 0 );
+
+        // Errors are cleared by a later success.
+        BEAST_EXPECT ( reader.parse ( "1", records ) );
+        BEAST_EXPECT ( reader.getFormatedErrorMessages ().empty () );
+    }
+
+    // The "n" of each record selected, or -1 on failure.
+    static std::vector<int>
+    select ( std::string const& document,
+             std::vector<std::string> const& needles,
+             std::function<bool (Json::Value const&)> const& predicate,
+             unsigned threads = 1 )
+    {
+        Json::LinesReader reader;
+        std::vector<Json::Value> records;
+
+        if ( !reader.select ( document.data (),
+                document.data () + document.size (), needles, predicate,
+                records, threads ) )
+            return { -1 };
+
+        std::vector<int> selected;
+
+        for ( auto const& record : records )
+            selected.push_back ( record["n"].asInt () );
+
+        return selected;
+    }
+
+    void
+    testSelect ()
+    {
+        testcase ("select");
+
+        auto const any = [] ( Json::Value const& ) { return true; };
+        using list = std::vector<int>;
+
+        std::string const document =
+            "{\"n\":0,\"account\":\"rA\",\"note\":\"x\"}\n"
+            "{\"n\":1,\"account\":\"rB\",\"note\":\"rA\"}\r\n"
+            "\n"
+            "{\"n\":2,\"account\":\"rC\"}\n"
+            "{\"n\":3,\"account\":\"rA\",\"account2\":\"rA\"}";
+
+        BEAST_EXPECT ( select ( document, { "\"rA\"" }, any ) ==
+            list ( { 0, 1, 3 } ) );
+        BEAST_EXPECT ( select ( document, { "\"rZ\"" }, any ).empty () );
+
+        // The predicate confirms each candidate.
+        BEAST_EXPECT ( select ( document, { "\"rA\"" },
+            [] ( Json::Value const& v ) { return v["account"] == "rA"; } ) ==
+            list ( { 0, 3 } ) );
+
+        // Several needles select the union, in document order, once each.
+        BEAST_EXPECT ( select ( document, { "\"rC\"", "\"rA\"", "rA" }, any ) ==
+            list ( { 0, 1, 2, 3 } ) );
+        BEAST_EXPECT ( select ( document, {}, any ).empty () );
+
+        // An empty needle selects every record.
+        BEAST_EXPECT ( select ( document, { "\"rZ\"", "" }, any ) ==
+            list ( { 0, 1, 2, 3 } ) );
+
+        // A match across a line break belongs to no record.
+        BEAST_EXPECT ( select ( document, { "\"x\"}\n{" }, any ).empty () );
+        BEAST_EXPECT ( select ( document, { "}\r\n\n{" }, any ).empty () );
+        BEAST_EXPECT ( select ( document, { "\"x\"}" }, any ) == list ( { 0 } ) );
+
+        // Needles at the very start and end of the document.
+        BEAST_EXPECT ( select ( document, { "{\"n\":0" }, any ) == list ( { 0 } ) );
+        BEAST_EXPECT ( select ( document, { "\"rA\"}" }, any ) == list ( { 1, 3 } ) );
+        BEAST_EXPECT ( select ( document, { document + " " }, any ).empty () );
+
+        // Needles whose rarest byte repeats or comes first, over many
+        // records and threads.
+        std::string many;
+        list expected;
+
+        for ( int i = 0; i < 3000; ++i )
+        {
+            bool const hit = i % 7 == 3;
+            many += "{\"n\":" + std::to_string ( i ) + ",\"k\":\"" +
+                ( hit ? "zzqzz" : "zzzzz" ) + "\",\"v\":\"qq\"}\n";
+
+            if ( hit )
+                expected.push_back ( i );
+        }
+
+        for ( unsigned threads : { 1u, 3u } )
+        {
+            BEAST_EXPECT ( select ( many, { "zqz" }, any, threads ) == expected );
+            BEAST_EXPECT ( select ( many, { "\"zzqzz\"" }, any, threads ) ==
+                expected );
+        }
+
+        // Candidates that fail to parse are reported.
+        BEAST_EXPECT ( select ( "{\"n\":1}\n{\"n\":\"rA\"\n", { "rA" }, any ) ==
+            list ( { -1 } ) );
+    }
+
+    void
+    run () override
+    {
+        testOrder ();
+        testBlankLines ();
+        testErrors ();
+        testSelect ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_lines_reader, json, ripple);
+
+} // ripple
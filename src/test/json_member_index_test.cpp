@@ -0,0 +1,188 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_member_index.h>
+#include <json_reader.h>
+#include <ripple/beast/unit_test.h>
+#include <string>
+
+namespace ripple {
+
+class json_member_index_test : public beast::unit_test::suite
+{
+public:
+    void
+    testLookup ()
+    {
+        testcase ("lookup");
+
+        Json::Value object ( Json::objectValue );
+
+        for ( int i = 0; i < 1000; ++i )
+            object["key" + std::to_string ( i )] = i;
+
+        object[""] = "empty";
+        object["a long name that spans several blocks"] = "long";
+
+        Json::MemberIndex const index ( object );
+        BEAST_EXPECT ( index.size () == 1002 );
+
+        bool all = true;
+
+        for ( int i = 0; i < 1000; ++i )
+        {
+            auto const found = index.find ( "key" + std::to_string ( i ) );
+            all = all  &&  found  &&  *found == i;
+        }
+
+        BEAST_EXPECT ( all );
+        BEAST_EXPECT ( index.find ( "" )  &&  *index.find ( "" ) == "empty" );
+        BEAST_EXPECT ( index.find ( "a long name that spans several blocks" ) ==
+            &object["a long name that spans several blocks"] );
+
+        // Misses, including prefixes and extensions of indexed names.
+        BEAST_EXPECT ( !index.find ( "key1000" ) );
+        BEAST_EXPECT ( !index.find ( "key" ) );
+        BEAST_EXPECT ( !index.find ( "key10 " ) );
+        BEAST_EXPECT ( !index.find ( "a long name that spans several block" ) );
+        BEAST_EXPECT ( !index.find ( std::string ( "key1\0", 5 ) ) );
+        BEAST_EXPECT ( !index.find ( std::string ( "\0", 1 ) ) );
+
+        BEAST_EXPECT ( Json::MemberIndex ( Json::Value ( 5 ) ).size () == 0 );
+        BEAST_EXPECT ( !Json::MemberIndex ( Json::Value () ).find ( "" ) );
+    }
+
+    void
+    testInsert ()
+    {
+        testcase ("insert");
+
+        // Names are compared in full, whatever bytes they hold.
+        Json::Value values[4] = { 1, 2, 3, 4 };
+        std::string const names[4] =
+        {
+            std::string ( "a\0b", 3 ),
+            std::string ( "a\0c", 3 ),
+            std::string ( "a", 1 ),
+            std::string ( "\xff\x80\"", 3 )
+        };
+
+        Json::MemberIndex index;
+        BEAST_EXPECT ( !index.find ( "a" ) );
+
+        for ( int i = 0; i < 4; ++i )
+            index.insert ( names[i].data (), names[i].size (), values[i] );
+
+        BEAST_EXPECT ( index.size () == 4 );
+
+        for ( int i = 0; i < 4; ++i )
+            BEAST_EXPECT ( index.find ( names[i] ) == &values[i] );
+
+        BEAST_EXPECT ( !index.find ( std::string ( "a\0", 2 ) ) );
+
+        // Growing keeps every entry.
+        std::vector<Json::Value> many ( 5000 );
+        Json::MemberIndex grown;
+
+        for ( std::size_t i = 0; i < many.size (); ++i )
+        {
+            std::string const name = std::to_string ( i );
+            grown.insert ( name.data (), name.size (), many[i] );
+        }
+
+        bool all = grown.size () == many.size ();
+
+        for ( std::size_t i = 0; i < many.size (); ++i )
+            all = all  &&  grown.find ( std::to_string ( i ) ) == &many[i];
+
+        BEAST_EXPECT ( all );
+    }
+
+    void
+    testReader ()
+    {
+        testcase ("reader");
+
+        std::string document = "{\"small\":{\"a\":1,\"b\":2},\"wide\":{";
+
+        for ( int i = 0; i < 100; ++i )
+            document += ( i ? ",\"m" : "\"m" ) + std::to_string ( i ) +
+                "\":" + std::to_string ( i );
+
+        document += "}}";
+
+        Json::Reader reader;
+        reader.indexMembers ( 10 );
+        Json::Value root;
+        BEAST_EXPECT ( reader.parse ( document, root ) );
+
+        BEAST_EXPECT ( !reader.memberIndex ( root ) );
+        BEAST_EXPECT ( !reader.memberIndex ( root["small"] ) );
+
+        auto const index = reader.memberIndex ( root["wide"] );
+
+        if ( BEAST_EXPECT ( index ) )
+        {
+            BEAST_EXPECT ( index->size () == 100 );
+            bool all = true;
+
+            for ( int i = 0; i < 100; ++i )
+            {
+                auto const found = index->find ( "m" + std::to_string ( i ) );
+                all = all  &&  found == &root["wide"]["m" + std::to_string ( i )];
+            }
+
+            BEAST_EXPECT ( all );
+            BEAST_EXPECT ( !index->find ( "m100" ) );
+        }
+
+        // Indexes do not outlive a failed parse.
+        BEAST_EXPECT ( !reader.parse (
+            document.substr ( 0, document.size () - 1 ), root ) );
+        BEAST_EXPECT ( !reader.memberIndex ( root["wide"] ) );
+
+        // Nor are they built once indexing stops.
+        reader.indexMembers ( 0 );
+        BEAST_EXPECT ( reader.parse ( document, root ) );
+        BEAST_EXPECT ( !reader.memberIndex ( root["wide"] ) );
+
+        // Elements read one at a time are indexed in turn.
+        reader.indexMembers ( 2 );
+        BEAST_EXPECT ( reader.beginArray ( "[{\"a\":1,\"b\":2},{\"c\":3}]" ) );
+        Json::Value element;
+        BEAST_EXPECT ( reader.nextElement ( element ) );
+        BEAST_EXPECT ( reader.memberIndex ( element )  &&
+            reader.memberIndex ( element )->find ( "b" ) == &element["b"] );
+        BEAST_EXPECT ( reader.nextElement ( element ) );
+        BEAST_EXPECT ( !reader.memberIndex ( element ) );
+    }
+
+    void
+    run () override
+    {
+        testLookup ();
+        testInsert ();
+        testReader ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_member_index, json, ripple);
+
+} // ripple
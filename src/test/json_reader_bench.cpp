@@ -0,0 +1,470 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_reader.h>
+#include <ripple/beast/unit_test.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined (__GLIBC__)
+#include <malloc.h>
+#endif
+
+#if defined (__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Reference parsers are compiled in when their vendored sources are on the
+// include path, for example extras/rapidjson/include, extras/simdjson and
+// extras/boost-json/include. simdjson's amalgamated simdjson.cpp must then
+// be built alongside this file; Boost.JSON is built from its headers here.
+#if defined (__has_include)
+# if __has_include (<rapidjson/document.h>)
+#  define JSON_BENCH_RAPIDJSON 1
+#  include <rapidjson/document.h>
+# endif
+# if __has_include (<simdjson.h>)
+#  define JSON_BENCH_SIMDJSON 1
+#  include <simdjson.h>
+# endif
+# if __has_include (<boost/json.hpp>)
+#  define JSON_BENCH_BOOST_JSON 1
+#  include <boost/json.hpp>
+#  include <boost/json/src.hpp>
+# endif
+#endif
+
+namespace ripple {
+
+/** Compares Json::Reader with reference parsers on the same corpora.
+
+    Each parser builds a complete document tree from each corpus, and the
+    best throughput over several runs is reported with the heap memory the
+    tree retains. The corpora are synthetic unless the suite argument names
+    files, separated by commas.
+
+    On Linux, hardware counters are read for one further run and reported
+    per input byte. Counters the kernel does not allow, as is common in
+    containers, are shown as '-'.
+
+    This is a manual suite, run only when selected by name.
+*/
+class json_reader_bench_test : public beast::unit_test::suite
+{
+    struct Corpus
+    {
+        std::string name;
+        std::string text;
+    };
+
+    struct Result
+    {
+        bool ok;
+        std::size_t bytes;
+    };
+
+    struct Parser
+    {
+        std::string name;
+        std::function<Result (std::string const&)> parse;
+        // Whether the parser reads only top-level arrays.
+        bool arraysOnly;
+    };
+
+    // The calling thread's hardware counters, opened separately so that
+    // those available are read even when others are not.
+    class Counters
+    {
+    public:
+        enum Event
+        {
+            cycles,
+            instructions,
+            branchMisses,
+            l1Misses,
+            llcMisses,
+            eventCount
+        };
+
+        Counters ()
+        {
+            std::fill ( std::begin ( fds_ ), std::end ( fds_ ), -1 );
+#if defined (__linux__)
+            open ( cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES );
+            open ( instructions, PERF_TYPE_HARDWARE,
+                PERF_COUNT_HW_INSTRUCTIONS );
+            open ( branchMisses, PERF_TYPE_HARDWARE,
+                PERF_COUNT_HW_BRANCH_MISSES );
+            open ( l1Misses, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                ( PERF_COUNT_HW_CACHE_OP_READ << 8 ) |
+                ( PERF_COUNT_HW_CACHE_RESULT_MISS << 16 ) );
+            open ( llcMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES );
+#endif
+        }
+
+        Counters ( Counters const& ) = delete;
+        Counters& operator= ( Counters const& ) = delete;
+
+        ~Counters ()
+        {
+#if defined (__linux__)
+            for ( int fd : fds_ )
+                if ( fd != -1 )
+                    close ( fd );
+#endif
+        }
+
+        void
+        start ()
+        {
+#if defined (__linux__)
+            for ( int fd : fds_ )
+            {
+                if ( fd != -1 )
+                {
+                    ioctl ( fd, PERF_EVENT_IOC_RESET, 0 );
+                    ioctl ( fd, PERF_EVENT_IOC_ENABLE, 0 );
+                }
+            }
+#endif
+        }
+
+        void
+        stop ()
+        {
+#if defined (__linux__)
+            for ( int fd : fds_ )
+                if ( fd != -1 )
+                    ioctl ( fd, PERF_EVENT_IOC_DISABLE, 0 );
+#endif
+        }
+
+        bool
+        read ( Event event, std::uint64_t& value ) const
+        {
+#if defined (__linux__)
+            return fds_[event] != -1  &&
+                ::read ( fds_[event], &value, sizeof ( value ) ) ==
+                    sizeof ( value );
+#else
+            return false;
+#endif
+        }
+
+    private:
+#if defined (__linux__)
+        void
+        open ( Event event, std::uint32_t type, std::uint64_t config )
+        {
+            perf_event_attr attr {};
+            attr.size = sizeof ( attr );
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fds_[event] = static_cast<int> ( syscall ( __NR_perf_event_open,
+                &attr, 0, -1, -1, 0 ) );
+
+            if ( fds_[event] < 0 )
+                fds_[event] = -1;
+        }
+#endif
+
+        int fds_[eventCount];
+    };
+
+    // Heap bytes in use, or zero where that cannot be told. glibc counts
+    // only its main arena, so trees built on other threads are undercounted.
+    static std::size_t
+    heapInUse ()
+    {
+#if defined (__GLIBC__) && \
+        ( __GLIBC__ > 2  ||  ( __GLIBC__ == 2  &&  __GLIBC_MINOR__ >= 33 ) )
+        return mallinfo2 ().uordblks;
+#else
+        return 0;
+#endif
+    }
+
+    static std::size_t
+    retained ( std::size_t before )
+    {
+        std::size_t const after = heapInUse ();
+        return after > before ? after - before : 0;
+    }
+
+    static std::vector<Corpus>
+    synthetic ()
+    {
+        std::vector<Corpus> corpora;
+        std::string text = "[";
+
+        for ( int i = 0; i < 20000; ++i )
+        {
+            text += i ? "," : "";
+            text += "{\"TransactionType\":\"Payment\",\"Account\":"
+                "\"rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh\",\"Destination\":"
+                "\"rPEPPER7kfTD9w2To4CQk6UCfuHM9c6GDY\",\"Amount\":{"
+                "\"currency\":\"USD\",\"issuer\":"
+                "\"rvYAfWj5gh67oV6fW32ZzP3Aw4Eubs59B\",\"value\":\"" +
+                std::to_string ( i ) + ".25\"},\"Fee\":\"12\",\"Sequence\":" +
+                std::to_string ( i ) + ",\"Flags\":2147483648,\"Memos\":[{"
+                "\"Memo\":{\"MemoType\":\"746578742F706C61696E\"}}]}";
+        }
+
+        corpora.push_back ( { "transactions", text + "]" } );
+
+        text = "[";
+
+        for ( int i = 0; i < 5000; ++i )
+        {
+            text += i ? ",\"" : "\"";
+
+            for ( int j = 0; j < 20; ++j )
+                text += "plain text \\\"quoted\\\" \\u00e9\\ud83d\\ude00\\n";
+
+            text += "\"";
+        }
+
+        corpora.push_back ( { "strings", text + "]" } );
+
+        text = "[";
+
+        for ( int i = 0; i < 200000; ++i )
+            text += ( i ? "," : "" ) + std::to_string ( i * 7919 % 1000003 ) +
+                ( i % 2 ? ".125e-3" : "" );
+
+        corpora.push_back ( { "numbers", text + "]" } );
+
+        text = "[";
+
+        for ( int i = 0; i < 1000000; ++i )
+            text += ( i ? "," : "" ) + ( i % 2 ? std::to_string ( i ) :
+                "{\"i\":" + std::to_string ( i ) + "}" );
+
+        corpora.push_back ( { "million elements", text + "]" } );
+
+        text = "{";
+
+        for ( int i = 0; i < 100000; ++i )
+            text += ( i ? ",\"n" : "\"n" ) + std::to_string ( i ) + "\":" +
+                std::to_string ( i );
+
+        corpora.push_back ( { "wide object", text + "}" } );
+        return corpora;
+    }
+
+    std::vector<Corpus>
+    corpora ()
+    {
+        if ( arg ().empty () )
+            return synthetic ();
+
+        std::vector<Corpus> result;
+        std::istringstream names ( arg () );
+        std::string name;
+
+        while ( std::getline ( names, name, ',' ) )
+        {
+            std::ifstream file ( name, std::ios::binary );
+
+            if ( !expect ( file.good (), "cannot open " + name ) )
+                continue;
+
+            result.push_back ( { name, std::string (
+                std::istreambuf_iterator<char> ( file ),
+                std::istreambuf_iterator<char> () ) } );
+        }
+
+        return result;
+    }
+
+    static std::vector<Parser>
+    parsers ()
+    {
+        std::vector<Parser> result;
+
+        result.push_back ( { "Json::Reader", [] ( std::string const& text )
+        {
+            std::size_t const before = heapInUse ();
+            Json::Reader reader;
+            Json::Value root;
+            bool const ok = reader.parse ( text.data (),
+                text.data () + text.size (), root );
+            return Result { ok, retained ( before ) };
+        }, false });
+
+        // Contiguous element storage, built on one thread and on four.
+        for ( unsigned const threads : { 1u, 4u } )
+        {
+            result.push_back ( { "Reader vector/" + std::to_string ( threads ),
+                [threads] ( std::string const& text )
+            {
+                std::size_t const before = heapInUse ();
+                Json::Reader reader;
+                std::vector<Json::Value> elements;
+                bool const ok = reader.parse ( text.data (),
+                    text.data () + text.size (), elements, threads );
+                return Result { ok, retained ( before ) };
+            }, true });
+        }
+
+#if JSON_BENCH_RAPIDJSON
+        result.push_back ( { "RapidJSON", [] ( std::string const& text )
+        {
+            std::size_t const before = heapInUse ();
+            rapidjson::Document document;
+            document.Parse ( text.data (), text.size () );
+            return Result { !document.HasParseError (), retained ( before ) };
+        }, false });
+#endif
+
+#if JSON_BENCH_SIMDJSON
+        result.push_back ( { "simdjson", [] ( std::string const& text )
+        {
+            std::size_t const before = heapInUse ();
+            simdjson::dom::parser parser;
+            simdjson::dom::element root;
+            bool const ok = !parser.parse ( text ).get ( root );
+            return Result { ok, retained ( before ) };
+        }, false });
+#endif
+
+#if JSON_BENCH_BOOST_JSON
+        result.push_back ( { "Boost.JSON", [] ( std::string const& text )
+        {
+            std::size_t const before = heapInUse ();
+            boost::json::error_code ec;
+            boost::json::value const root = boost::json::parse ( text, ec );
+            return Result { !ec, retained ( before ) };
+        }, false });
+#endif
+
+        return result;
+    }
+
+    void
+    measure ( Parser const& parser, Corpus const& corpus )
+    {
+        using clock = std::chrono::steady_clock;
+
+        // The best of at least three runs, taking a quarter second or more.
+        double best = 0;
+        Result result { false, 0 };
+        auto const start = clock::now ();
+
+        for ( int run = 0; run < 3  ||
+                clock::now () - start < std::chrono::milliseconds ( 250 ); ++run )
+        {
+            auto const before = clock::now ();
+            result = parser.parse ( corpus.text );
+            std::chrono::duration<double> const elapsed = clock::now () - before;
+
+            if ( run == 0  ||  elapsed.count () < best )
+                best = elapsed.count ();
+
+            if ( !result.ok )
+                break;
+        }
+
+        if ( !expect ( result.ok, parser.name + " rejects " + corpus.name ) )
+            return;
+
+        char line[160];
+        std::snprintf ( line, sizeof ( line ), "%-16s %-20s %10.1f MB/s %12s",
+            parser.name.c_str (), corpus.name.c_str (),
+            corpus.text.size () / best / 1e6,
+            result.bytes ? ( std::to_string ( result.bytes / 1024 ) +
+                " KiB" ).c_str () : "-" );
+        log << line << std::endl;
+
+        Counters counters;
+        counters.start ();
+        parser.parse ( corpus.text );
+        counters.stop ();
+
+        double const size = corpus.text.size ();
+        std::uint64_t cycles = 0;
+        std::uint64_t instructions = 0;
+        std::uint64_t value = 0;
+        bool const haveCycles = counters.read ( Counters::cycles, cycles );
+        bool const haveInstructions =
+            counters.read ( Counters::instructions, instructions );
+
+        // A counter per byte, or '-' when it could not be read.
+        auto const perByte = [&] ( Counters::Event event )
+        {
+            char text[32] = "-";
+
+            if ( counters.read ( event, value ) )
+                std::snprintf ( text, sizeof ( text ), "%.3f", value / size );
+
+            return std::string ( text );
+        };
+
+        char ipc[32] = "-";
+
+        if ( haveCycles  &&  haveInstructions  &&  cycles != 0 )
+            std::snprintf ( ipc, sizeof ( ipc ), "%.2f",
+                double ( instructions ) / cycles );
+
+        log << "    per byte: cycles " << perByte ( Counters::cycles ) <<
+            ", instructions " << perByte ( Counters::instructions ) <<
+            ", branch misses " << perByte ( Counters::branchMisses ) <<
+            ", L1 misses " << perByte ( Counters::l1Misses ) <<
+            ", LLC misses " << perByte ( Counters::llcMisses ) <<
+            "; IPC " << ipc << std::endl;
+    }
+
+public:
+    void
+    run () override
+    {
+        auto const all = parsers ();
+
+        for ( auto const& corpus : corpora () )
+        {
+            log << corpus.name << ": " << corpus.text.size () << " bytes" <<
+                std::endl;
+
+            for ( auto const& parser : all )
+                if ( !parser.arraysOnly  ||  corpus.text.front () == '[' )
+                    measure ( parser, corpus );
+        }
+
+        pass ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE_MANUAL(json_reader_bench, json, ripple);
+
+} // ripple
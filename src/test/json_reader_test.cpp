@@ -0,0 +1,639 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_reader.h>
+#include <ripple/beast/unit_test.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class json_reader_test : public beast::unit_test::suite
+{
+    // Parse from a buffer holding exactly the document, so any read past
+    // its end is caught by the sanitizers.
+    static bool
+    parse ( std::string const& text, Json::Value& root, std::string& errors )
+    {
+        std::vector<char> buffer ( text.begin (), text.end () );
+        Json::Reader reader;
+        bool const ok = reader.parse ( buffer.data (),
+            buffer.data () + buffer.size (), root );
+        errors = reader.getFormatedErrorMessages ();
+        return ok;
+    }
+
+    static bool
+    parse ( std::string const& text )
+    {
+        Json::Value root;
+        std::string errors;
+        return parse ( text, root, errors );
+    }
+
+    static std::string
+    repeat ( std::string const& s, std::size_t count )
+    {
+        std::string result;
+        result.reserve ( s.size () * count );
+
+        for ( std::size_t i = 0; i < count; ++i )
+            result += s;
+
+        return result;
+    }
+
+    // Best of three times taken to parse text and format its errors.
+    static double
+    parseSeconds ( std::string const& text )
+    {
+        double best = 0;
+
+        for ( int i = 0; i < 3; ++i )
+        {
+            auto const start = std::chrono::steady_clock::now ();
+            Json::Value root;
+            std::string errors;
+            parse ( text, root, errors );
+            std::chrono::duration<double> const elapsed =
+                std::chrono::steady_clock::now () - start;
+            best = i == 0 ? elapsed.count () : std::min ( best, elapsed.count () );
+        }
+
+        return best;
+    }
+
+    // Doubling the size of the input made by make(n) four times may
+    // multiply the time by at most 3 each time, where quadratic work
+    // multiplies it by 4. The slack absorbs timer noise on tiny inputs.
+    void
+    expectLinear ( std::string const& name,
+                   std::function<std::string (std::size_t)> const& make )
+    {
+        std::size_t const size = 64 * 1024;
+        double const first = parseSeconds ( make ( size ) );
+        double const last = parseSeconds ( make ( 16 * size ) );
+
+        expect ( last < 81 * first + 0.002, name + ": " +
+            std::to_string ( first ) + "s, then " +
+            std::to_string ( last ) + "s for 16 times the input" );
+    }
+
+public:
+    void
+    testNesting ()
+    {
+        testcase ("nesting");
+
+        auto const nested = [] ( std::size_t depth, char open, char close )
+        {
+            std::string text ( depth, open );
+
+            if ( open == '{' )
+            {
+                text.clear ();
+
+                for ( std::size_t i = 0; i < depth; ++i )
+                    text += i + 1 < depth ? "{\"a\":" : "{";
+            }
+
+            return text + std::string ( depth, close );
+        };
+
+        // The root is at depth 0, so nest_limit + 1 levels are accepted.
+        BEAST_EXPECT ( parse ( nested ( 26, '[', ']' ) ) );
+        BEAST_EXPECT ( !parse ( nested ( 27, '[', ']' ) ) );
+        BEAST_EXPECT ( parse ( nested ( 26, '{', '}' ) ) );
+        BEAST_EXPECT ( !parse ( nested ( 27, '{', '}' ) ) );
+
+        Json::Value root;
+        std::string errors;
+        BEAST_EXPECT ( !parse ( nested ( 27, '[', ']' ), root, errors ) );
+        BEAST_EXPECT ( errors.find ( "maximum nesting depth" ) !=
+            std::string::npos );
+
+        // Hostile depths must fail quickly rather than exhaust the stack.
+        BEAST_EXPECT ( !parse ( std::string ( 1000000, '[' ) ) );
+        BEAST_EXPECT ( !parse ( nested ( 1000000, '[', ']' ) ) );
+        BEAST_EXPECT ( !parse ( nested ( 100000, '{', '}' ) ) );
+    }
+
+    void
+    testTruncated ()
+    {
+        testcase ("truncated");
+
+        std::string const document =
+            "{\"a\":[1,-2,3.5e1,\"x\\u00e9\\n\"],\r\n"
+            "\"b\":{\"c\":true,\"d\":null} /* note */, \"e\":[]}";
+
+        BEAST_EXPECT ( parse ( document ) );
+
+        // Every proper prefix is incomplete and must be rejected without
+        // reading past its end, including while locating the error.
+        for ( std::size_t size = 0; size < document.size (); ++size )
+        {
+            Json::Value root;
+            std::string errors;
+            expect ( !parse ( document.substr ( 0, size ), root, errors ),
+                "prefix " + std::to_string ( size ) );
+        }
+
+        BEAST_EXPECT ( !parse ( "{\"a\":\"\\u12" ) );
+        BEAST_EXPECT ( !parse ( "[\r" ) );
+    }
+
+    // The elements read one at a time from text, and whether the reader
+    // ended without errors.
+    static bool
+    pull ( std::string const& text, std::vector<Json::Value>& elements )
+    {
+        std::vector<char> buffer ( text.begin (), text.end () );
+        Json::Reader reader;
+        elements.clear ();
+
+        if ( !reader.beginArray ( buffer.data (), buffer.data () + buffer.size () ) )
+            return false;
+
+        Json::Value element;
+
+        while ( reader.nextElement ( element ) )
+            elements.push_back ( element );
+
+        // Once finished, it stays finished.
+        if ( reader.nextElement ( element ) )
+            return false;
+
+        return reader.good ();
+    }
+
+    void
+    testPullArray ()
+    {
+        testcase ("pull array");
+
+        std::vector<Json::Value> elements;
+
+        BEAST_EXPECT ( pull ( "[]", elements ) );
+        BEAST_EXPECT ( elements.empty () );
+        BEAST_EXPECT ( pull ( " \r\n[ \t]", elements ) );
+        BEAST_EXPECT ( elements.empty () );
+
+        BEAST_EXPECT ( pull ( "[1, \"a\", {\"b\":[true]}, [], null]", elements ) );
+        BEAST_EXPECT ( elements.size () == 5 );
+        BEAST_EXPECT ( elements[1] == "a" );
+        BEAST_EXPECT ( elements[2]["b"][0u] == true );
+        BEAST_EXPECT ( elements[3].isArray ()  &&  elements[4].isNull () );
+
+        BEAST_EXPECT ( pull ( "/* a */ [ /* b */ 1 /* c */, // d\n 2 // e\n]",
+            elements ) );
+        BEAST_EXPECT ( elements.size () == 2 );
+        BEAST_EXPECT ( elements[1] == 2 );
+
+        // Errors end the array after the elements read so far.
+        BEAST_EXPECT ( !pull ( "[1,]", elements ) );
+        BEAST_EXPECT ( elements.size () == 1 );
+        BEAST_EXPECT ( !pull ( "[1 2]", elements ) );
+        BEAST_EXPECT ( elements.size () == 1 );
+        BEAST_EXPECT ( !pull ( "[1,2", elements ) );
+        BEAST_EXPECT ( elements.size () == 2 );
+        BEAST_EXPECT ( !pull ( "[", elements ) );
+        BEAST_EXPECT ( elements.empty () );
+        BEAST_EXPECT ( !pull ( "[,1]", elements ) );
+        BEAST_EXPECT ( !pull ( "[{\"a\":}]", elements ) );
+        BEAST_EXPECT ( !pull ( "[1 /* c", elements ) );
+        BEAST_EXPECT ( !pull ( "{\"a\":1}", elements ) );
+        BEAST_EXPECT ( !pull ( "", elements ) );
+
+        // The errors match those of a whole parse.
+        for ( auto const text : { "[1,]", "[1 2]", "[1,2", "[[1,]" } )
+        {
+            Json::Reader reader;
+            Json::Reader whole;
+            Json::Value element;
+            Json::Value root;
+
+            BEAST_EXPECT ( reader.beginArray ( text ) );
+
+            while ( reader.nextElement ( element ) )
+                ;
+
+            BEAST_EXPECT ( !reader.good () );
+            BEAST_EXPECT ( !whole.parse ( text, root ) );
+            expect ( reader.getFormatedErrorMessages () ==
+                whole.getFormatedErrorMessages (), text );
+        }
+    }
+
+    void
+    testScaling ()
+    {
+        testcase ("scaling");
+
+        // An error deep in nested containers is recovered from at every
+        // level, each time scanning ahead for a closing token that never
+        // comes.
+        expectLinear ( "error in nested arrays", [] ( std::size_t n )
+        {
+            return std::string ( 24, '[' ) + "[x" + repeat ( "1,", n / 2 );
+        });
+
+        expectLinear ( "error in nested objects", [] ( std::size_t n )
+        {
+            return repeat ( "{\"a\":", 24 ) + "x" + repeat ( "[1],", n / 4 );
+        });
+
+        expectLinear ( "errors in sibling containers", [] ( std::size_t n )
+        {
+            return "[" + repeat ( "[{\"a\":[1,}],", n / 13 );
+        });
+
+        expectLinear ( "nesting past the limit", [] ( std::size_t n )
+        {
+            return std::string ( n, '[' );
+        });
+
+        expectLinear ( "unterminated string", [] ( std::size_t n )
+        {
+            return "[\"" + std::string ( n, 'a' );
+        });
+
+        expectLinear ( "unterminated string of escapes", [] ( std::size_t n )
+        {
+            return "[\"" + repeat ( "\\\"", n / 2 );
+        });
+
+        expectLinear ( "unterminated comment", [] ( std::size_t n )
+        {
+            return "[1,/*" + std::string ( n, '*' );
+        });
+
+        expectLinear ( "line comments", [] ( std::size_t n )
+        {
+            return "[1" + repeat ( "//\n", n / 3 ) + "x";
+        });
+
+        // Locating an error counts the lines before it.
+        expectLinear ( "CR LF lines before an error", [] ( std::size_t n )
+        {
+            return "[" + repeat ( "\r\n", n / 2 ) + "x";
+        });
+
+        expectLinear ( "CR lines before an error", [] ( std::size_t n )
+        {
+            return "[" + repeat ( "1,\r", n / 3 ) + "x";
+        });
+
+        expectLinear ( "long number", [] ( std::size_t n )
+        {
+            return "[" + std::string ( n, '1' ) + "]";
+        });
+
+        expectLinear ( "long real", [] ( std::size_t n )
+        {
+            return "[0." + std::string ( n, '1' ) + "]";
+        });
+
+        expectLinear ( "wide object", [] ( std::size_t n )
+        {
+            std::string text = "{";
+
+            for ( std::size_t i = 0; text.size () < n; ++i )
+                text += "\"" + std::to_string ( i ) + "\":0,";
+
+            return text + "\"0\":0}";
+        });
+    }
+
+    void
+    testConcurrent ()
+    {
+        testcase ("concurrent");
+
+        std::string document = "[";
+
+        for ( int i = 0; i < 1000; ++i )
+        {
+            if ( i != 0 )
+                document += ",";
+
+            document += "{\"index\":" + std::to_string ( i ) +
+                ",\"name\":\"a:b,{c}[d]\",\"list\":[{\"x\":1},[]]}";
+        }
+
+        document += "]";
+        char const* const begin = document.data ();
+        char const* const end = begin + document.size ();
+
+        // An array of objects must be split and built on several threads.
+        {
+            Json::Reader reader;
+            std::vector<Json::Value> elements;
+            BEAST_EXPECT ( reader.readElementsConcurrently (
+                begin, end, elements, 4 ) );
+            BEAST_EXPECT ( elements.size () == 1000 );
+
+            Json::Value sequential;
+            BEAST_EXPECT ( Json::Reader ().parse ( begin, end, sequential ) );
+
+            bool same = elements.size () == sequential.size ();
+
+            for ( Json::Value::UInt i = 0; same  &&  i < elements.size (); ++i )
+                same = elements[i] == sequential[i];
+
+            BEAST_EXPECT ( same );
+        }
+
+        {
+            Json::Reader reader;
+            Json::Value root;
+            BEAST_EXPECT ( reader.parse ( begin, end, root, 4 ) );
+            BEAST_EXPECT ( root.size () == 1000 );
+            BEAST_EXPECT ( root[999u]["index"].asInt () == 999 );
+        }
+
+        // Elements built concurrently do not use the string pool, which
+        // shows which path the vector overload took.
+        {
+            Json::StringPool pool;
+            Json::Reader reader;
+            reader.setStringPool ( &pool );
+            std::vector<Json::Value> elements;
+            BEAST_EXPECT ( reader.parse ( begin, end, elements, 4 ) );
+            BEAST_EXPECT ( elements.size () == 1000 );
+            BEAST_EXPECT ( pool.size () == 0 );
+
+            BEAST_EXPECT ( reader.parse ( begin, end, elements, 1 ) );
+            BEAST_EXPECT ( elements.size () == 1000 );
+            BEAST_EXPECT ( pool.size () != 0 );
+        }
+
+        // Only string values are pooled, never member names, so copies of
+        // objects do not refer to the pool.
+        {
+            Json::StringPool pool;
+            Json::Reader reader;
+            reader.setStringPool ( &pool );
+            Json::Value root;
+            BEAST_EXPECT ( reader.parse ( "[{\"name\":\"v\"},"
+                "{\"name\":\"v\",\"other\":\"w\"}]", root ) );
+            BEAST_EXPECT ( pool.size () == 2 );
+            BEAST_EXPECT ( pool.bytesSaved () == 2 );
+        }
+
+        // Comments fall back to the sequential reader.
+        {
+            std::string const commented = "[{\"a\":1}, /* c */ {\"a\":2}]";
+            Json::Reader reader;
+            std::vector<Json::Value> elements;
+            BEAST_EXPECT ( !reader.readElementsConcurrently ( commented.data (),
+                commented.data () + commented.size (), elements, 2 ) );
+            BEAST_EXPECT ( reader.parse ( commented.data (),
+                commented.data () + commented.size (), elements, 2 ) );
+            BEAST_EXPECT ( elements.size () == 2 );
+        }
+    }
+
+    void
+    testVector ()
+    {
+        testcase ("vector");
+
+        std::size_t const count = 1000000;
+        std::string document = "[";
+
+        for ( std::size_t i = 0; i < count; ++i )
+        {
+            if ( i != 0 )
+                document += ",";
+
+            switch ( i % 4 )
+            {
+            case 0:  document += std::to_string ( i ); break;
+            case 1:  document += "\"s" + std::to_string ( i ) + "\""; break;
+            case 2:  document += "{\"i\":" + std::to_string ( i ) + "}"; break;
+            default: document += "[" + std::to_string ( i ) + ",null]"; break;
+            }
+        }
+
+        document += "]";
+        char const* const begin = document.data ();
+        char const* const end = begin + document.size ();
+
+        for ( unsigned const threads : { 1u, 4u } )
+        {
+            Json::Reader reader;
+            std::vector<Json::Value> elements;
+            BEAST_EXPECT ( reader.parse ( begin, end, elements, threads ) );
+            BEAST_EXPECT ( elements.size () == count );
+
+            bool same = elements.size () == count;
+
+            for ( std::size_t i = 0; same  &&  i < count; ++i )
+            {
+                auto const n = static_cast<int> ( i );
+
+                switch ( i % 4 )
+                {
+                case 0:  same = elements[i] == n; break;
+                case 1:  same = elements[i] == "s" + std::to_string ( i ); break;
+                case 2:  same = elements[i]["i"] == n; break;
+                default: same = elements[i][0u] == n  &&
+                    elements[i][1u].isNull (); break;
+                }
+            }
+
+            expect ( same, std::to_string ( threads ) + " threads" );
+        }
+
+        // An error in the last element fails the whole array.
+        document.back () = ',';
+        document += "]";
+        Json::Reader reader;
+        std::vector<Json::Value> elements;
+        BEAST_EXPECT ( !reader.parse ( document.data (),
+            document.data () + document.size (), elements, 4 ) );
+        BEAST_EXPECT ( !reader.good () );
+    }
+
+    void
+    testBase64 ()
+    {
+        testcase ("base64");
+
+        Json::Reader reader;
+        Json::Value root;
+
+        // Wrapped as validator tokens are in configuration files.
+        BEAST_EXPECT ( reader.parseBase64 (
+            "eyJhIjpb\n  MSwy\r\nXX0=\n", root ) );
+        BEAST_EXPECT ( root["a"][1u] == 2 );
+
+        // Text that is not base64 is reported against the encoded text.
+        BEAST_EXPECT ( !reader.parseBase64 ( "eyJhIjpb\nMSwy$XX0=", root ) );
+        BEAST_EXPECT ( reader.getFormatedErrorMessages () ==
+            "* Line 1, Column 1\n  The document is not valid base64.\n" );
+        BEAST_EXPECT ( !reader.parseBase64 ( "eyJhIjpbMSwyXX1=", root ) );
+        BEAST_EXPECT ( reader.parseBase64 ( "eyJhIjpbMSwyXX0", root ) );
+
+        // Decoded text that is not JSON is reported against the decoded
+        // text, which is then what the error locations refer to.
+        BEAST_EXPECT ( !reader.parseBase64 ( "eyJhIjpbMSxdfQ==", root ) );
+        BEAST_EXPECT ( reader.getFormatedErrorMessages ().compare (
+            0, 19, "* Line 1, Column 9\n" ) == 0 );
+
+        // The reader is usable afterwards.
+        BEAST_EXPECT ( reader.parse ( "[1]", root ) );
+        BEAST_EXPECT ( reader.good () );
+    }
+
+    void
+    testStreaming ()
+    {
+        testcase ("streaming");
+
+        std::size_t const chunk = Json::Reader::stream_chunk_size;
+
+        // Escapes, including a \\u surrogate pair, at every position around
+        // the first chunk boundary.
+        std::string const escapes = "\\n\\\"\\\\\\u00e9\\ud83d\\ude00x";
+
+        for ( std::size_t at = chunk - 12; at <= chunk + 2; ++at )
+        {
+            std::string const encoded = std::string ( at, 'a' ) + escapes +
+                std::string ( chunk + 100, 'b' ) + escapes;
+            std::string const document =
+                "{\"s\":\"" + encoded + "\",\"t\":[\"" + encoded + "\"]}";
+
+            Json::Reader reader;
+            reader.enableDocumentHash ( true );
+            Json::Value stored;
+            BEAST_EXPECT ( reader.parse ( document, stored ) );
+            auto const hash = reader.documentHash ();
+
+            // The chunks, each within the bound, make up the stored string,
+            // and the hash is unchanged whatever the handler stores.
+            for ( std::string const digest : { "", "digest" } )
+            {
+                std::vector<std::string> strings ( 1 );
+                bool bounded = true;
+
+                reader.streamLargeStrings ( chunk,
+                    [&] ( Json::Value& target, const char* data,
+                          std::size_t size, bool last )
+                    {
+                        bounded = bounded  &&  size <= chunk + 3;
+                        strings.back ().append ( data, size );
+
+                        if ( last )
+                        {
+                            target = digest;
+                            strings.emplace_back ();
+                        }
+                    } );
+
+                Json::Value streamed;
+                BEAST_EXPECT ( reader.parse ( document, streamed ) );
+                expect ( strings.size () == 3  &&
+                    strings[0] == stored["s"].asString ()  &&
+                    strings[1] == stored["t"][0u].asString (),
+                    "chunks at " + std::to_string ( at ) );
+                BEAST_EXPECT ( bounded );
+                BEAST_EXPECT ( streamed["s"] == digest );
+                expect ( reader.documentHash () == hash,
+                    "hash at " + std::to_string ( at ) );
+            }
+        }
+
+        // Strings below the threshold are stored as usual.
+        Json::Reader reader;
+        int calls = 0;
+        reader.streamLargeStrings ( 10, [&] ( Json::Value&, const char*,
+            std::size_t, bool ) { ++calls; } );
+        Json::Value root;
+        BEAST_EXPECT ( reader.parse ( "[\"short\",\"long enough\"]", root ) );
+        BEAST_EXPECT ( calls == 1 );
+        BEAST_EXPECT ( root[0u] == "short"  &&  root[1u] == "" );
+
+        // A string that fails part way does not deliver its last chunk.
+        calls = 0;
+        int lasts = 0;
+        reader.streamLargeStrings ( 1, [&] ( Json::Value&, const char*,
+            std::size_t, bool last ) { ++calls; lasts += last; } );
+        BEAST_EXPECT ( !reader.parse ( "[\"" + std::string ( chunk + 10, 'a' ) +
+            "\\q\"]", root ) );
+        BEAST_EXPECT ( calls == 1  &&  lasts == 0 );
+    }
+
+    void
+    testDocumentHash ()
+    {
+        testcase ("document hash");
+
+        auto const zero = [] ( Json::DocumentHash const& h )
+        {
+            return h == Json::DocumentHash { 0, 0 };
+        };
+
+        Json::Reader reader;
+        reader.enableDocumentHash ( true );
+        Json::Value root;
+
+        BEAST_EXPECT ( reader.parse ( "{\"a\":[1,2],\"b\":\"x\"}", root ) );
+        auto const first = reader.documentHash ();
+        BEAST_EXPECT ( !zero ( first ) );
+
+        BEAST_EXPECT ( reader.parse ( "{ \"b\" : \"x\", \"a\" : [1, 2] }", root ) );
+        BEAST_EXPECT ( reader.documentHash () == first );
+
+        // A scalar root is read, but the parse still fails.
+        BEAST_EXPECT ( !reader.parse ( "5", root ) );
+        BEAST_EXPECT ( zero ( reader.documentHash () ) );
+
+        BEAST_EXPECT ( !reader.parse ( "{\"a\":[1,2],\"b\":}", root ) );
+        BEAST_EXPECT ( zero ( reader.documentHash () ) );
+
+        std::string const trailing = "[1] 2";
+        BEAST_EXPECT ( !reader.parseValue ( trailing.data (),
+            trailing.data () + trailing.size (), root ) );
+        BEAST_EXPECT ( zero ( reader.documentHash () ) );
+    }
+
+    void
+    run () override
+    {
+        testNesting ();
+        testTruncated ();
+        testPullArray ();
+        testScaling ();
+        testConcurrent ();
+        testVector ();
+        testBase64 ();
+        testStreaming ();
+        testDocumentHash ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_reader, json, ripple);
+
+} // ripple
@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_schema.h>
+#include <json_reader.h>
+#include <ripple/beast/unit_test.h>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class json_schema_test : public beast::unit_test::suite
+{
+    static std::string
+    generate ( std::vector<std::string> const& documents )
+    {
+        std::vector<Json::Value> samples;
+
+        for ( auto const& document : documents )
+        {
+            Json::Value value;
+            Json::Reader ().parse ( document, value );
+            samples.push_back ( value );
+        }
+
+        return Json::Schema::infer ( samples ).generate ( "Record" );
+    }
+
+    static bool
+    contains ( std::string const& text, std::string const& part )
+    {
+        return text.find ( part ) != std::string::npos;
+    }
+
+public:
+    void
+    testInference ()
+    {
+        testcase ("inference");
+
+        auto const source = generate ( {
+            "{\"a\":1,\"b\":\"x\",\"c\":[{\"d\":true}],\"e\":null}",
+            "{\"a\":-1,\"b\":\"y\",\"c\":[],\"e\":2.5,\"f\":1.5}" } );
+
+        BEAST_EXPECT ( contains ( source, "    int a {};" ) );
+        BEAST_EXPECT ( contains ( source, "    std::string b {};" ) );
+        BEAST_EXPECT ( contains ( source, "    std::vector<::Record_c> c {};" ) );
+        BEAST_EXPECT ( contains ( source, "    Json::Value e {};" ) );
+        BEAST_EXPECT ( contains ( source, "field ( \"f\", &Record::f, true )" ) );
+        BEAST_EXPECT ( contains ( source, "field ( \"a\", &Record::a )" ) );
+
+        // Scalar roots have no struct.
+        BEAST_EXPECT ( generate ( { "[1,2]" } ).empty () );
+    }
+
+    void
+    testIdentifiers ()
+    {
+        testcase ("identifiers");
+
+        auto const source = generate ( {
+            "{\"and\":1,\"try\":1,\"typename\":1,\"__k\":1,\"_Up\":1,"
+            "\"a__b\":1,\"9\":1,\"Record\":1,\"b_c\":{\"x\":1},"
+            "\"b.c\":{\"y\":1}}" } );
+
+        BEAST_EXPECT ( contains ( source, " and_ {};" ) );
+        BEAST_EXPECT ( contains ( source, " try_ {};" ) );
+        BEAST_EXPECT ( contains ( source, " typename_ {};" ) );
+        BEAST_EXPECT ( contains ( source, " m_k {};" ) );
+        BEAST_EXPECT ( contains ( source, " m_Up {};" ) );
+        BEAST_EXPECT ( contains ( source, " a_b {};" ) );
+        BEAST_EXPECT ( contains ( source, " m9 {};" ) );
+        BEAST_EXPECT ( contains ( source, " Record_2 {};" ) );
+        BEAST_EXPECT ( !contains ( source, "__k {};" )  &&  !contains ( source, "a__b {};" ) );
+
+        // Members whose nested type names coincide get distinct types.
+        BEAST_EXPECT ( contains ( source, "struct Record_b_c\n" ) );
+        BEAST_EXPECT ( contains ( source, "struct Record_b_c_2\n" ) );
+    }
+
+    void
+    run () override
+    {
+        testInference ();
+        testIdentifiers ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_schema, json, ripple);
+
+} // ripple
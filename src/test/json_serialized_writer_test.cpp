@@ -0,0 +1,226 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_serialized_writer.h>
+#include <json_reader.h>
+#include <ripple/beast/unit_test.h>
+#include <random>
+#include <string>
+
+namespace ripple {
+
+class json_serialized_writer_test : public beast::unit_test::suite
+{
+    static std::string
+    unhex ( std::string const& hex )
+    {
+        std::string bytes;
+
+        for ( std::size_t i = 0; i + 1 < hex.size (); i += 2 )
+            bytes += static_cast<char> ( std::stoi ( hex.substr ( i, 2 ), nullptr, 16 ) );
+
+        return bytes;
+    }
+
+    // Whether the object writes, checking that anything written reads
+    // back through Reader.
+    bool
+    writes ( std::string const& bytes, Json::Value& value )
+    {
+        Json::SerializedWriter writer;
+
+        if ( !writer.write ( bytes.data (), bytes.size () ) )
+            return false;
+
+        Json::Reader reader;
+        expect ( reader.parse ( writer.text (), value ),
+            reader.getFormatedErrorMessages () );
+        return true;
+    }
+
+    bool
+    writes ( std::string const& bytes )
+    {
+        Json::Value value;
+        return writes ( bytes, value );
+    }
+
+public:
+    void
+    testFields ()
+    {
+        testcase ("fields");
+
+        std::string const account = "B5F762798A53D543A014CAF8B297CFF8F2F937E8";
+        std::string const usd = "0000000000000000000000005553440000000000";
+
+        Json::Value tx;
+        BEAST_EXPECT ( writes ( unhex (
+            "120000" "2280000000" "2400000001" "6140000000000F4240"
+            "68400000000000000A"
+            "69D4838D7EA4C68000" + usd + account +
+            "8114" + account +
+            "F9EA7C03414243E1F1"
+            "011201" + account + "30" + usd + account + "FF10" +
+                std::string ( 40, '0' ) + "00" ), tx ) );
+
+        BEAST_EXPECT ( tx["TransactionType"] == "Payment" );
+        BEAST_EXPECT ( tx["Flags"].asUInt () == 2147483648u );
+        BEAST_EXPECT ( tx["Amount"] == "1000000" );
+        BEAST_EXPECT ( tx["Fee"] == "10" );
+        BEAST_EXPECT ( tx["Account"] == "rHb9CJAWyB4rj91VRWn96DkukG4bwdtyTh" );
+        BEAST_EXPECT ( tx["SendMax"]["currency"] == "USD" );
+        BEAST_EXPECT ( tx["SendMax"]["value"] == "1" );
+        BEAST_EXPECT ( tx["Memos"][0u]["Memo"]["MemoType"] == "414243" );
+        BEAST_EXPECT ( tx["Paths"].size () == 2 );
+        BEAST_EXPECT ( tx["Paths"][1u][0u]["currency"] == "XRP" );
+
+        // Neither the set nor any of its paths may be empty.
+        std::string const element = "01" + account;
+        BEAST_EXPECT ( writes ( unhex ( "0112" + element + "00" ), tx ) );
+        BEAST_EXPECT ( tx["Paths"].size () == 1  &&  tx["Paths"][0u].size () == 1 );
+        BEAST_EXPECT ( !writes ( unhex ( "011200" ) ) );
+        BEAST_EXPECT ( !writes ( unhex ( "0112FF00" ) ) );
+        BEAST_EXPECT ( !writes ( unhex ( "0112FF" + element + "00" ) ) );
+        BEAST_EXPECT ( !writes ( unhex ( "0112" + element + "FF00" ) ) );
+        BEAST_EXPECT ( !writes ( unhex ( "0112" + element + "FFFF" + element + "00" ) ) );
+
+        Json::SerializedWriter writer;
+        std::string const empty = unhex ( "011200" );
+        BEAST_EXPECT ( !writer.write ( empty.data (), empty.size () ) );
+        BEAST_EXPECT ( writer.getFormatedErrorMessages ().find ( "Empty path." ) !=
+            std::string::npos );
+
+        // Unknown and repeated fields are rejected.
+        BEAST_EXPECT ( !writes ( unhex ( "2F00000000" ) ) );
+        BEAST_EXPECT ( !writes ( unhex ( "24000000012400000002" ) ) );
+        BEAST_EXPECT ( !writes ( unhex ( "1200" ) ) );
+    }
+
+    void
+    testNesting ()
+    {
+        testcase ("nesting");
+
+        // n Memo objects, one inside the other, with a field in the last.
+        auto const memos = [] ( int n, std::string const& inner )
+        {
+            std::string bytes;
+
+            for ( int i = 0; i < n; ++i )
+                bytes += '\xea';
+
+            bytes += inner;
+
+            for ( int i = 0; i < n; ++i )
+                bytes += '\xe1';
+
+            return bytes;
+        };
+
+        // n levels of a Memos array holding a Memo object.
+        auto const arrays = [] ( int n, std::string const& inner )
+        {
+            std::string bytes;
+
+            for ( int i = 0; i < n; ++i )
+                bytes += "\xf9\xea";
+
+            bytes += inner;
+
+            for ( int i = 0; i < n; ++i )
+                bytes += "\xe1\xf1";
+
+            return bytes;
+        };
+
+        std::string const scalar = unhex ( "2400000001" );
+        std::string const amount = unhex ( "61D4838D7EA4C68000" +
+            std::string ( 80, '1' ) );
+        std::string const path = unhex ( "011201" + std::string ( 40, '1' ) + "00" );
+
+        // Reader accepts values down to depth 25.
+        BEAST_EXPECT ( writes ( memos ( 25, "" ) ) );
+        BEAST_EXPECT ( !writes ( memos ( 26, "" ) ) );
+        BEAST_EXPECT ( writes ( memos ( 24, scalar ) ) );
+        BEAST_EXPECT ( !writes ( memos ( 25, scalar ) ) );
+        BEAST_EXPECT ( writes ( memos ( 23, amount ) ) );
+        BEAST_EXPECT ( !writes ( memos ( 24, amount ) ) );
+        BEAST_EXPECT ( writes ( memos ( 21, path ) ) );
+        BEAST_EXPECT ( !writes ( memos ( 22, path ) ) );
+
+        // Each array level adds the array, the element and the object.
+        BEAST_EXPECT ( writes ( arrays ( 8, scalar ) ) );
+        BEAST_EXPECT ( !writes ( arrays ( 9, scalar ) ) );
+        BEAST_EXPECT ( writes ( arrays ( 8, "" ) ) );
+        BEAST_EXPECT ( !writes ( arrays ( 9, "" ) ) );
+
+        for ( int n = 0; n < 40; ++n )
+        {
+            writes ( memos ( n, scalar ) );
+            writes ( memos ( n, amount ) );
+            writes ( memos ( n, path ) );
+            writes ( arrays ( n / 3, memos ( n % 3, path ) ) );
+        }
+    }
+
+    void
+    testRandom ()
+    {
+        testcase ("random");
+
+        // Whatever is accepted must read back.
+        std::mt19937 engine ( 1 );
+        std::size_t written = 0;
+
+        for ( int i = 0; i < 100000; ++i )
+        {
+            std::string bytes ( engine () % 64, '\0' );
+
+            for ( auto& c : bytes )
+            {
+                switch ( engine () % 5 )
+                {
+                case 0:  c = '\xe1'; break;
+                case 1:  c = '\xea'; break;
+                case 2:  c = '\0'; break;
+                default: c = static_cast<char> ( engine () ); break;
+                }
+            }
+
+            if ( writes ( bytes ) )
+                ++written;
+        }
+
+        BEAST_EXPECT ( written != 0 );
+    }
+
+    void
+    run () override
+    {
+        testFields ();
+        testNesting ();
+        testRandom ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_serialized_writer, json, ripple);
+
+} // ripple
@@ -0,0 +1,283 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_sidecar_index.h>
+#include <ripple/beast/unit_test.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace ripple {
+
+class json_sidecar_index_test : public beast::unit_test::suite
+{
+public:
+    // A directory removed with everything in it when the test ends.
+    struct TemporaryDirectory
+    {
+        boost::filesystem::path path;
+
+        TemporaryDirectory ()
+            : path ( boost::filesystem::temp_directory_path () /
+                boost::filesystem::unique_path () )
+        {
+            boost::filesystem::create_directories ( path );
+        }
+
+        ~TemporaryDirectory ()
+        {
+            boost::system::error_code ec;
+            boost::filesystem::remove_all ( path, ec );
+        }
+
+        std::string operator/ ( std::string const& name ) const
+        {
+            return ( path / name ).string ();
+        }
+    };
+
+    static std::string
+    readFile ( std::string const& path )
+    {
+        std::ifstream file ( path, std::ios::binary );
+        std::ostringstream text;
+        text << file.rdbuf ();
+        return text.str ();
+    }
+
+    // Replace the contents of a file, keeping its modification time.
+    static void
+    rewrite ( std::string const& path, std::string const& text )
+    {
+        auto const modified = boost::filesystem::last_write_time ( path );
+        std::ofstream ( path, std::ios::binary | std::ios::trunc ) << text;
+        boost::filesystem::last_write_time ( path, modified );
+    }
+
+    // An array of n elements of varied kinds, with commas and brackets
+    // inside strings. Element i holds i as its "n" or as itself.
+    static std::string
+    makeArray ( std::size_t n )
+    {
+        std::string text = "[\n";
+
+        for ( std::size_t i = 0; i < n; ++i )
+        {
+            std::string const s = std::to_string ( i );
+
+            if ( i != 0 )
+                text += i % 3 ? "," : " ,\r\n ";
+
+            switch ( i % 4 )
+            {
+            case 0: text += s; break;
+            case 1: text += "{\"n\":" + s + ",\"s\":\"],[\\\"{\"}"; break;
+            case 2: text += "[" + s + ",[],{}]"; break;
+            default: text += "{\"n\":" + s + ",\"a\":[{\"b\":\",\"}]}"; break;
+            }
+        }
+
+        return text + "\n]\n";
+    }
+
+    static bool
+    holds ( Json::Value const& value, std::size_t i )
+    {
+        switch ( i % 4 )
+        {
+        case 0: return value == Json::Value::UInt ( i )  ||  value == int ( i );
+        case 2: return value[0u].asUInt () == i  &&  value.size () == 3;
+        default: return value["n"].asUInt () == i;
+        }
+    }
+
+    void
+    testLookup ()
+    {
+        testcase ("lookup");
+
+        TemporaryDirectory directory;
+        std::string const path = directory / "array.json";
+        std::string const sidecar = directory / "array.json.idx";
+        std::ofstream ( path, std::ios::binary ) << makeArray ( 1000 );
+
+        for ( std::size_t k : { 1, 7, 64, 1000, 5000 } )
+        {
+            Json::SidecarIndex built;
+            BEAST_EXPECT ( built.build ( path, sidecar, k ) );
+            BEAST_EXPECT ( built.size () == 1000 );
+
+            Json::SidecarIndex index;
+            BEAST_EXPECT ( index.open ( path, sidecar ) );
+            BEAST_EXPECT ( index.size () == 1000 );
+
+            bool all = true;
+            Json::Value value;
+
+            for ( std::size_t i = 0; i < 1000; ++i )
+                all = all  &&  index.element ( i, value )  &&  holds ( value, i );
+
+            expect ( all, "every " + std::to_string ( k ) );
+
+            BEAST_EXPECT ( !index.element ( 1000, value ) );
+            BEAST_EXPECT ( index.getFormatedErrorMessages () ==
+                "Element 1000 is out of range.\n" );
+        }
+
+        // Empty and single element arrays.
+        for ( std::string const text : { "[]", " [ ] ", "[{\"a\":[]}]" } )
+        {
+            std::ofstream ( path, std::ios::binary | std::ios::trunc ) << text;
+            Json::SidecarIndex index;
+            BEAST_EXPECT ( index.build ( path, sidecar, 4 ) );
+            BEAST_EXPECT ( index.open ( path, sidecar ) );
+            BEAST_EXPECT ( index.size () == ( text.size () > 5 ? 1u : 0u ) );
+        }
+
+        // Only arrays without comments are indexed.
+        for ( std::string const text :
+                { "{\"a\":1}", "[1,/* c */2]", "[1,2", "" } )
+        {
+            std::ofstream ( path, std::ios::binary | std::ios::trunc ) << text;
+            Json::SidecarIndex index;
+            expect ( !index.build ( path, sidecar ), text );
+        }
+    }
+
+    void
+    testStale ()
+    {
+        testcase ("stale");
+
+        TemporaryDirectory directory;
+        std::string const path = directory / "array.json";
+        std::string const sidecar = directory / "array.json.idx";
+        std::string const text = makeArray ( 50000 );
+        BEAST_EXPECT ( text.size () > 4 * 64 * 1024 );
+        std::ofstream ( path, std::ios::binary ) << text;
+
+        Json::SidecarIndex index;
+        BEAST_EXPECT ( index.build ( path, sidecar, 100 ) );
+        BEAST_EXPECT ( index.open ( path, sidecar ) );
+
+        // A changed size.
+        rewrite ( path, text + " " );
+        BEAST_EXPECT ( !index.open ( path, sidecar ) );
+        BEAST_EXPECT ( index.getFormatedErrorMessages ().find (
+            "is out of date" ) != std::string::npos );
+
+        // The same size, with a change in the head or in the tail.
+        std::string changed = text;
+        changed[10] = changed[10] == '1' ? '2' : '1';
+        rewrite ( path, changed );
+        BEAST_EXPECT ( !index.open ( path, sidecar ) );
+
+        changed = text;
+        changed[text.size () - 100] = changed[text.size () - 100] == '1' ? '2' : '1';
+        rewrite ( path, changed );
+        BEAST_EXPECT ( !index.open ( path, sidecar ) );
+
+        // A change to the middle that keeps the size and modification time
+        // is not detected, as documented.
+        changed = text;
+        auto const middle = text.find ( "{\"n\":25001," );
+        changed.replace ( middle, 11, "{\"n\":25009," );
+        rewrite ( path, changed );
+        BEAST_EXPECT ( index.open ( path, sidecar ) );
+        Json::Value value;
+        BEAST_EXPECT ( index.element ( 25001, value )  &&
+            value["n"] == 25009 );
+
+        BEAST_EXPECT ( !index.open ( directory / "missing", sidecar ) );
+        BEAST_EXPECT ( !index.open ( path, directory / "missing" ) );
+    }
+
+    void
+    testCorrupt ()
+    {
+        testcase ("corrupt");
+
+        TemporaryDirectory directory;
+        std::string const path = directory / "array.json";
+        std::string const sidecar = directory / "array.json.idx";
+        std::ofstream ( path, std::ios::binary ) << makeArray ( 100 );
+
+        Json::SidecarIndex index;
+        BEAST_EXPECT ( index.build ( path, sidecar, 10 ) );
+        std::string const good = readFile ( sidecar );
+        BEAST_EXPECT ( good.size () == 8 + 6 * 8 + 10 * 8 );
+
+        auto corrupt = [&] ( std::string const& bytes )
+        {
+            std::ofstream ( sidecar, std::ios::binary | std::ios::trunc ) << bytes;
+            Json::SidecarIndex other;
+            return !other.open ( path, sidecar );
+        };
+
+        auto setWord = [] ( std::string bytes, std::size_t word,
+                            std::uint64_t value )
+        {
+            for ( int i = 0; i < 8; ++i )
+                bytes[8 + 8 * word + i] = static_cast<char> ( value >> ( 8 * i ) );
+
+            return bytes;
+        };
+
+        BEAST_EXPECT ( !corrupt ( good ) );
+
+        // A sample count far beyond the sidecar's size is rejected
+        // without being allocated.
+        std::uint64_t const huge = ~std::uint64_t ( 0 ) / 8;
+        BEAST_EXPECT ( corrupt ( setWord ( setWord ( good, 4, huge * 10 ), 5, huge ) ) );
+        BEAST_EXPECT ( corrupt ( setWord ( good, 5, 11 ) ) );
+        BEAST_EXPECT ( corrupt ( setWord ( good, 4, 101 ) ) );
+        BEAST_EXPECT ( corrupt ( setWord ( setWord ( good, 4, ~std::uint64_t ( 0 ) ), 3, 1 ) ) );
+        BEAST_EXPECT ( corrupt ( setWord ( good, 3, 0 ) ) );
+
+        // Truncated or extended.
+        BEAST_EXPECT ( corrupt ( good.substr ( 0, good.size () - 8 ) ) );
+        BEAST_EXPECT ( corrupt ( good.substr ( 0, 20 ) ) );
+        BEAST_EXPECT ( corrupt ( good + std::string ( 8, '\0' ) ) );
+        BEAST_EXPECT ( corrupt ( "" ) );
+
+        // Offsets must increase and lie within the file.
+        BEAST_EXPECT ( corrupt ( setWord ( good, 6 + 3, 0 ) ) );
+        BEAST_EXPECT ( corrupt ( setWord ( good, 6 + 3, 1 ) ) );
+        BEAST_EXPECT ( corrupt ( setWord ( good, 6 + 9, 1 << 20 ) ) );
+        BEAST_EXPECT ( corrupt ( setWord ( good, 6, 0 ) ) );
+
+        std::string magic = good;
+        magic[0] = 'X';
+        BEAST_EXPECT ( corrupt ( magic ) );
+    }
+
+    void
+    run () override
+    {
+        testLookup ();
+        testStale ();
+        testCorrupt ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_sidecar_index, json, ripple);
+
+} // ripple
@@ -0,0 +1,149 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_struct_reader.h>
+#include <json_struct_writer.h>
+#include <ripple/beast/unit_test.h>
+#include <clocale>
+#include <climits>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+struct json_struct_writer_test_record
+{
+    int number {};
+    unsigned count {};
+    double ratio {};
+    bool flag {};
+    std::string name {};
+    std::vector<double> values {};
+    Json::Value extra {};
+};
+
+} // ripple
+
+namespace Json {
+
+template <>
+struct Binding<ripple::json_struct_writer_test_record>
+{
+    using record = ripple::json_struct_writer_test_record;
+
+    static constexpr auto fields ()
+    {
+        return std::make_tuple (
+            field ( "number", &record::number ),
+            field ( "count", &record::count ),
+            field ( "ratio", &record::ratio ),
+            field ( "flag", &record::flag ),
+            field ( "name", &record::name ),
+            field ( "values", &record::values ),
+            field ( "extra", &record::extra, true ) );
+    }
+};
+
+} // Json
+
+namespace ripple {
+
+class json_struct_writer_test : public beast::unit_test::suite
+{
+    using record = json_struct_writer_test_record;
+
+    void
+    roundTrip ( record const& r )
+    {
+        Json::StructWriter writer;
+        Json::StructReader reader;
+        Json::Value fallback;
+        record copy;
+
+        std::string const text = writer.write ( r );
+        expect ( reader.parse ( text, copy, fallback ) ==
+            Json::StructReader::bound, text );
+        expect ( writer.write ( copy ) == text, text );
+    }
+
+public:
+    void
+    testRoundTrip ()
+    {
+        testcase ("round trip");
+
+        record r;
+        r.number = INT_MIN;
+        r.count = UINT_MAX;
+        r.ratio = 1.5;
+        r.flag = true;
+        r.name = "quote \" backslash \\ newline \n control \x01 utf8 \xc3\xa9";
+        r.values = { 0.1, -2.5e-300, 123456789012.0, 1e300 };
+        r.extra["a"][0u] = 1;
+        r.extra["b"] = "x";
+        roundTrip ( r );
+
+        Json::StructWriter writer;
+        record empty;
+        BEAST_EXPECT ( writer.write ( empty ) ==
+            "{\"number\":0,\"count\":0,\"ratio\":0.0,\"flag\":false,"
+            "\"name\":\"\",\"values\":[],\"extra\":null}" );
+    }
+
+    void
+    testLocale ()
+    {
+        testcase ("locale");
+
+        char const* const locales[] =
+            { "de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "C.UTF-8" };
+
+        std::string const previous = std::setlocale ( LC_NUMERIC, nullptr );
+
+        for ( auto const name : locales )
+        {
+            if ( !std::setlocale ( LC_NUMERIC, name ) )
+                continue;
+
+            record r;
+            r.ratio = 1.5;
+            r.values = { -0.25, 2e-5 };
+
+            Json::StructWriter writer;
+            std::string const text = writer.write ( r );
+            expect ( text.find ( "\"ratio\":1.5," ) != std::string::npos, text );
+            expect ( text.find ( "[-0.25,2.0000000000000002e-05]" ) !=
+                std::string::npos, text );
+        }
+
+        std::setlocale ( LC_NUMERIC, previous.c_str () );
+    }
+
+    void
+    run () override
+    {
+        testRoundTrip ();
+        testLocale ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_struct_writer, json, ripple);
+
+} // ripple
@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_structural_index.h>
+#include <ripple/beast/unit_test.h>
+#include <random>
+#include <string>
+
+namespace ripple {
+
+class json_structural_index_test : public beast::unit_test::suite
+{
+    // The entries of the index of text, built on the given threads.
+    static Json::StructuralIndex::Offsets
+    index ( std::string const& text, unsigned threads )
+    {
+        return Json::StructuralIndex ( text.data (),
+            text.data () + text.size (), threads ).offsets ();
+    }
+
+public:
+    void
+    testSequential ()
+    {
+        testcase ("sequential");
+
+        std::string const text =
+            "{\"a\\\"{\":[1,\"\\\\\",\"x]\"],/*c*/\"b\":{}}";
+        Json::StructuralIndex::Offsets const expected
+            { 0, 7, 8, 10, 15, 20, 21, 22, 26, 30, 31, 32, 33 };
+
+        BEAST_EXPECT ( index ( text, 1 ) == expected );
+        BEAST_EXPECT ( index ( "", 1 ).empty () );
+        BEAST_EXPECT ( index ( "\"[,]", 1 ).empty () );
+    }
+
+    void
+    testThreads ()
+    {
+        testcase ("threads");
+
+        // Chunks are at least 1 MiB, so seven threads need over 7 MiB.
+        std::size_t const size = 8 * 1024 * 1024 + 13;
+        char const alphabet[] = "\"\"\\\\\\{}[]:,/ xy";
+        std::mt19937 engine ( 7 );
+        std::string text ( size, ' ' );
+
+        for ( auto& c : text )
+            c = alphabet[engine () % ( sizeof ( alphabet ) - 1 )];
+
+        auto const expected = index ( text, 1 );
+
+        for ( unsigned const threads : { 2u, 3u, 7u } )
+        {
+            // Straddle each chunk boundary with a run of backslashes and a
+            // quote, alternating which side of the boundary each lies on.
+            std::string straddled = text;
+            std::size_t const chunk = size / threads;
+
+            for ( unsigned i = 1; i < threads; ++i )
+            {
+                std::size_t const boundary = i * chunk;
+                std::size_t const run = i % 4 + 1;
+                std::size_t const first = boundary - run + ( i % 2 );
+
+                straddled[first - 1] = 'x';
+                straddled.replace ( first, run, run, '\\' );
+                straddled[first + run] = '"';
+                straddled[first + run + 1] = ',';
+            }
+
+            expect ( index ( text, threads ) == expected,
+                std::to_string ( threads ) + " threads" );
+            expect ( index ( straddled, threads ) == index ( straddled, 1 ),
+                std::to_string ( threads ) + " threads, straddled" );
+        }
+    }
+
+    void
+    run () override
+    {
+        testSequential ();
+        testThreads ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_structural_index, json, ripple);
+
+} // ripple
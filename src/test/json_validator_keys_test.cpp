@@ -0,0 +1,413 @@
+//------------------------------------------------------------------------------
+/*
+    This file is part of rippled: https://github.com/ripple/rippled
+    Copyright (c) 2012, 2013 Ripple Labs Inc.
+
+    Permission to use, copy, modify, and/or distribute this software for any
+    purpose  with  or without fee is hereby granted, provided that the above
+    copyright notice and this permission notice appear in all copies.
+
+    THE  SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+    WITH  REGARD  TO  THIS  SOFTWARE  INCLUDING  ALL  IMPLIED  WARRANTIES  OF
+    MERCHANTABILITY  AND  FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+    ANY  SPECIAL ,  DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+    WHATSOEVER  RESULTING  FROM  LOSS  OF USE, DATA OR PROFITS, WHETHER IN AN
+    ACTION  OF  CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+    OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+*/
+//==============================================================================
+
+#include <BeastConfig.h>
+#include <json_base58.h>
+#include <json_base64.h>
+#include <json_reader.h>
+#include <json_validator_keys.h>
+#include <ripple/beast/unit_test.h>
+#include <string>
+#include <vector>
+
+namespace ripple {
+
+class json_validator_keys_test : public beast::unit_test::suite
+{
+public:
+    static std::string
+    fromHex ( std::string const& hex )
+    {
+        std::string bytes;
+
+        for ( std::size_t i = 0; i + 1 < hex.size (); i += 2 )
+            bytes += static_cast<char> (
+                std::stoi ( hex.substr ( i, 2 ), nullptr, 16 ) );
+
+        return bytes;
+    }
+
+    template <std::size_t N>
+    static std::string
+    toString ( std::array<std::uint8_t, N> const& bytes )
+    {
+        return std::string ( bytes.begin (), bytes.end () );
+    }
+
+    static Json::ValidatorKeys
+    derive ( Json::KeyType type, std::string const& secret )
+    {
+        Json::ValidatorKeys keys;
+        Json::KeyGenerator generator ( type );
+        generator.derive (
+            reinterpret_cast<std::uint8_t const*> ( secret.data () ), keys );
+        return keys;
+    }
+
+    void
+    testBase58 ()
+    {
+        testcase ("base58");
+
+        auto encode = [] ( std::uint8_t type, std::string const& data )
+        {
+            std::string text;
+            Json::base58CheckEncode ( type,
+                reinterpret_cast<std::uint8_t const*> ( data.data () ),
+                data.size (), text );
+            return text;
+        };
+
+        auto decode = [] ( std::uint8_t type, std::string const& text,
+            std::string& data )
+        {
+            data.clear ();
+            return Json::base58CheckDecode ( type, text.data (),
+                text.data () + text.size (), data );
+        };
+
+        // The well known zero and one accounts.
+        std::string const zero ( 20, '\0' );
+        std::string const one = zero.substr ( 1 ) + '\1';
+        BEAST_EXPECT ( encode ( Json::tokenAccountId, zero ) ==
+            "rrrrrrrrrrrrrrrrrrrrrhoLvTp" );
+        BEAST_EXPECT ( encode ( Json::tokenAccountId, one ) ==
+            "rrrrrrrrrrrrrrrrrrrrBZbvji" );
+
+        std::string data;
+        BEAST_EXPECT ( decode ( Json::tokenAccountId,
+            "rrrrrrrrrrrrrrrrrrrrBZbvji", data )  &&  data == one );
+
+        // Round trips of node keys.
+        std::string const key = fromHex ( "ED"
+            "0000ED9434799226374926EDA3B54B1B461B4ABF7237962EAE18528FEA9C07A8" );
+        std::string const text = encode ( Json::tokenNodePublic, key );
+        BEAST_EXPECT ( text[0] == 'n' );
+        BEAST_EXPECT ( decode ( Json::tokenNodePublic, text, data )  &&
+            data == key );
+
+        // Another type, a changed digit, a character outside the alphabet.
+        BEAST_EXPECT ( !decode ( Json::tokenNodePrivate, text, data ) );
+        std::string changed = text;
+        changed[10] = changed[10] == 'r' ? 'p' : 'r';
+        BEAST_EXPECT ( !decode ( Json::tokenNodePublic, changed, data ) );
+        changed = text;
+        changed[10] = '0';
+        BEAST_EXPECT ( !decode ( Json::tokenNodePublic, changed, data ) );
+        BEAST_EXPECT ( !decode ( Json::tokenNodePublic, "", data ) );
+        BEAST_EXPECT ( !decode ( Json::tokenNodePublic, "rrrr", data ) );
+    }
+
+    void
+    testDerive ()
+    {
+        testcase ("derive");
+
+        // RFC 8032, test 1.
+        auto keys = derive ( Json::KeyType::ed25519, fromHex (
+            "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60" ) );
+        BEAST_EXPECT ( toString ( keys.publicKey ) == fromHex (
+            "ED"
+            "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a" ) );
+
+        // The secp256k1 generator and its double.
+        std::string secret ( 32, '\0' );
+        secret[31] = 1;
+        keys = derive ( Json::KeyType::secp256k1, secret );
+        BEAST_EXPECT ( toString ( keys.publicKey ) == fromHex (
+            "0279BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798" ) );
+        secret[31] = 2;
+        keys = derive ( Json::KeyType::secp256k1, secret );
+        BEAST_EXPECT ( toString ( keys.publicKey ) == fromHex (
+            "02C6047F9441ED7D6D3045406E95C07CD85C778E4B8CEF3CA7ABAC09B95C709EE5" ) );
+
+        // Zero and the group order are not secp256k1 secret keys.
+        Json::KeyGenerator generator ( Json::KeyType::secp256k1 );
+        std::string const order = fromHex (
+            "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141" );
+        BEAST_EXPECT ( !generator.derive (
+            reinterpret_cast<std::uint8_t const*> ( order.data () ), keys ) );
+        std::string const zero ( 32, '\0' );
+        BEAST_EXPECT ( !generator.derive (
+            reinterpret_cast<std::uint8_t const*> ( zero.data () ), keys ) );
+    }
+
+    void
+    testGenerate ()
+    {
+        testcase ("generate");
+
+        // Every key of a batch is the one its secret derives on its own.
+        for ( auto type : { Json::KeyType::ed25519, Json::KeyType::secp256k1 } )
+        {
+            for ( bool candidates : { false, true } )
+            {
+                Json::KeyGenerator generator ( type );
+                std::vector<Json::ValidatorKeys> batch ( 50 );
+
+                auto generate = [&]
+                {
+                    if ( candidates )
+                        generator.generateCandidates ( batch );
+                    else
+                        generator.generate ( batch );
+                };
+
+                generate ();
+                bool all = true;
+
+                for ( auto const& keys : batch )
+                {
+                    auto const derived =
+                        derive ( type, toString ( keys.secretKey ) );
+                    all = all  &&  keys.keyType == type  &&
+                        derived.publicKey == keys.publicKey;
+                }
+
+                BEAST_EXPECT ( all );
+                BEAST_EXPECT ( batch[0].secretKey != batch[1].secretKey );
+
+                // Successive batches start afresh.
+                auto const first = batch[0].secretKey;
+                generate ();
+                BEAST_EXPECT ( batch[0].secretKey != first );
+
+                // Only search candidates may have related secrets.
+                auto next = batch[0].secretKey;
+
+                for ( int i = 31; i >= 0  &&  ++next[i] == 0; --i )
+                    ;
+
+                BEAST_EXPECT ( ( next == batch[1].secretKey ) ==
+                    ( candidates  &&  type == Json::KeyType::secp256k1 ) );
+            }
+        }
+    }
+
+    void
+    testKeyFile ()
+    {
+        testcase ("key file");
+
+        for ( auto type : { Json::KeyType::ed25519, Json::KeyType::secp256k1 } )
+        {
+            Json::KeyGenerator generator ( type );
+            std::vector<Json::ValidatorKeys> batch ( 1 );
+            generator.generate ( batch );
+
+            Json::Value file = batch[0].toJson ();
+            BEAST_EXPECT ( file["key_type"] == ( type == Json::KeyType::ed25519 ?
+                "ed25519" : "secp256k1" ) );
+            BEAST_EXPECT ( file["public_key"].asString ()[0] == 'n' );
+            BEAST_EXPECT ( file["secret_key"].asString ()[0] == 'p' );
+            BEAST_EXPECT ( file["revoked"] == false );
+            BEAST_EXPECT ( file["token_sequence"] == Json::Value::UInt ( 0 ) );
+
+            Json::ValidatorKeys keys;
+            BEAST_EXPECT ( Json::ValidatorKeys::fromJson ( file, keys ) );
+            BEAST_EXPECT ( keys.keyType == type  &&
+                keys.secretKey == batch[0].secretKey  &&
+                keys.publicKey == batch[0].publicKey );
+
+            // The public key must be the one the secret key derives.
+            generator.generate ( batch );
+            Json::Value other = file;
+            other["public_key"] = batch[0].publicKeyText ();
+            BEAST_EXPECT ( !Json::ValidatorKeys::fromJson ( other, keys ) );
+
+            other = file;
+            other["key_type"] = "rsa";
+            BEAST_EXPECT ( !Json::ValidatorKeys::fromJson ( other, keys ) );
+
+            other = file;
+            other["secret_key"] = file["public_key"];
+            BEAST_EXPECT ( !Json::ValidatorKeys::fromJson ( other, keys ) );
+        }
+    }
+
+    void
+    testSign ()
+    {
+        testcase ("sign");
+
+        // RFC 8032, test 1: the empty message.
+        auto keys = derive ( Json::KeyType::ed25519, fromHex (
+            "9d61b19deffd5a60ba844af492ec2cc44449c5697b326919703bac031cae7f60" ) );
+        std::string signature;
+        BEAST_EXPECT ( Json::sign ( keys, "", signature ) );
+        BEAST_EXPECT ( signature == fromHex (
+            "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e065224901555"
+            "fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b" ) );
+        BEAST_EXPECT ( Json::verify ( keys.publicKey, "", signature ) );
+        BEAST_EXPECT ( !Json::verify ( keys.publicKey, "x", signature ) );
+
+        Json::KeyGenerator generator ( Json::KeyType::secp256k1 );
+        std::vector<Json::ValidatorKeys> batch ( 2 );
+        generator.generate ( batch );
+
+        // ECDSA is randomized, so sign often enough to meet high S values.
+        bool all = true;
+
+        for ( int i = 0; i < 20; ++i )
+        {
+            std::string const message = "message " + std::to_string ( i );
+            all = all  &&  Json::sign ( batch[0], message, signature )  &&
+                Json::verify ( batch[0].publicKey, message, signature )  &&
+                !Json::verify ( batch[1].publicKey, message, signature )  &&
+                !Json::verify ( batch[0].publicKey, message + ".", signature );
+
+            // Trailing bytes make the encoding not strict DER.
+            all = all  &&  !Json::verify (
+                batch[0].publicKey, message, signature + '\0' );
+        }
+
+        BEAST_EXPECT ( all );
+    }
+
+    void
+    testToken ()
+    {
+        testcase ("token");
+
+        for ( auto type : { Json::KeyType::ed25519, Json::KeyType::secp256k1 } )
+        {
+            Json::KeyGenerator generator ( type );
+            Json::KeyGenerator ephemeral ( Json::KeyType::secp256k1 );
+            std::vector<Json::ValidatorKeys> masters ( 2 );
+            std::vector<Json::ValidatorKeys> signing ( 1 );
+            generator.generate ( masters );
+            ephemeral.generate ( signing );
+
+            std::string token;
+            BEAST_EXPECT ( Json::createToken (
+                masters[0], signing[0], 7, token ) );
+
+            std::string errors;
+            BEAST_EXPECT ( Json::checkToken ( token, masters[0], 7, errors ) );
+            BEAST_EXPECT ( errors.empty () );
+
+            // The token is base64 JSON with the manifest and secret key.
+            std::string text;
+            BEAST_EXPECT ( Json::base64Decode (
+                token.data (), token.data () + token.size (), text ) );
+            Json::Reader reader;
+            Json::Value object;
+            BEAST_EXPECT ( reader.parse ( text, object ) );
+            BEAST_EXPECT ( object["validation_secret_key"].asString ().size () == 64 );
+
+            BEAST_EXPECT ( !Json::checkToken ( token, masters[0], 8, errors ) );
+            BEAST_EXPECT ( errors == "The manifest has the wrong sequence." );
+            BEAST_EXPECT ( !Json::checkToken ( token, masters[1], 7, errors ) );
+            BEAST_EXPECT ( errors == "The manifest is for another master key." );
+            BEAST_EXPECT ( !Json::checkToken ( "!" + token, masters[0], 7, errors ) );
+            BEAST_EXPECT ( errors == "The token is not base64." );
+
+            // Change one byte of the master signature, the last field.
+            std::string const encoded = object["manifest"].asString ();
+            std::string manifest;
+            Json::base64Decode ( encoded.data (),
+                encoded.data () + encoded.size (), manifest );
+            manifest.back () ^= 1;
+            std::string forged = "{\"manifest\":\"";
+            Json::base64Encode ( manifest.data (), manifest.size (), forged );
+            forged += "\",\"validation_secret_key\":\"" +
+                object["validation_secret_key"].asString () + "\"}";
+            token.clear ();
+            Json::base64Encode ( forged.data (), forged.size (), token );
+            BEAST_EXPECT ( !Json::checkToken ( token, masters[0], 7, errors ) );
+            BEAST_EXPECT ( errors == "The master signature is invalid." );
+
+            // A secret key for other signing keys.
+            forged = "{\"manifest\":\"" + encoded +
+                "\",\"validation_secret_key\":\"" +
+                std::string ( 63, '1' ) + "2\"}";
+            token.clear ();
+            Json::base64Encode ( forged.data (), forged.size (), token );
+            BEAST_EXPECT ( !Json::checkToken ( token, masters[0], 7, errors ) );
+            BEAST_EXPECT ( errors == "The validation secret key does not "
+                "match the signing public key." );
+        }
+    }
+
+    void
+    testSearch ()
+    {
+        testcase ("search");
+
+        for ( auto type : { Json::KeyType::ed25519, Json::KeyType::secp256k1 } )
+        {
+            // A prefix one in a few hundred keys has.
+            Json::KeyGenerator generator ( type );
+            std::vector<Json::ValidatorKeys> batch ( 1 );
+            generator.generate ( batch );
+            std::string const prefix = batch[0].publicKeyText ().substr ( 0, 3 );
+
+            Json::KeySearch search ( type, 3 );
+            BEAST_EXPECT ( search.setPrefix ( prefix ) );
+            search.setLimit ( 1000000 );
+
+            Json::ValidatorKeys keys;
+
+            if ( BEAST_EXPECT ( search.run ( keys ) ) )
+            {
+                BEAST_EXPECT ( keys.publicKeyText ().compare (
+                    0, prefix.size (), prefix ) == 0 );
+                BEAST_EXPECT ( derive ( type, toString ( keys.secretKey ) )
+                    .publicKey == keys.publicKey );
+                BEAST_EXPECT ( search.attempts () > 0 );
+                BEAST_EXPECT ( search.keysPerSecond () > 0 );
+            }
+
+            // A pattern anywhere in the key.
+            BEAST_EXPECT ( search.setPattern ( "[a-z][0-9]$" ) );
+
+            if ( BEAST_EXPECT ( search.run ( keys ) ) )
+                BEAST_EXPECT ( std::regex_search ( keys.publicKeyText (),
+                    std::regex ( "[a-z][0-9]$" ) ) );
+
+            // The threads stop together at the limit.
+            BEAST_EXPECT ( search.setPrefix ( "nzzzzzzzzzzzz" ) );
+            search.setLimit ( 1000 );
+            BEAST_EXPECT ( !search.run ( keys ) );
+            BEAST_EXPECT ( search.attempts () == 1000 );
+        }
+
+        Json::KeySearch search ( Json::KeyType::ed25519 );
+        BEAST_EXPECT ( !search.setPrefix ( "r" ) );
+        BEAST_EXPECT ( !search.setPrefix ( "n0" ) );
+        BEAST_EXPECT ( !search.setPrefix ( std::string ( "n\0", 2 ) ) );
+        BEAST_EXPECT ( !search.setPattern ( "(" ) );
+    }
+
+    void
+    run () override
+    {
+        testBase58 ();
+        testDerive ();
+        testGenerate ();
+        testKeyFile ();
+        testSign ();
+        testToken ();
+        testSearch ();
+    }
+};
+
+BEAST_DEFINE_TESTSUITE(json_validator_keys, json, ripple);
+
+} // ripple